@@ -26,92 +26,481 @@ SOFTWARE.
 
 #include "LSM6DSO16IS.h"
 #include <cstdint>
+#include <string.h>
 
 
+#ifndef LSM6DSO16IS_HOST_BUILD
 // Costruttore privato per I2C
 LSM6DSO16IS::LSM6DSO16IS(PinName sda, PinName scl) {
+    bus = NULL;
     i2c = new I2C(sda, scl);
+    spi = NULL;
+    cs_pin = NULL;
+    int1_pin = NULL;
+    int2_pin = NULL;
     initialize();
 }
 
 // Costruttore privato per SPI
 LSM6DSO16IS::LSM6DSO16IS(PinName mosi, PinName miso, PinName sck, PinName cs) {
     // Inizializzazione del sensore tramite SPI
+    bus = NULL;
+    i2c = NULL;
+    spi = new SPI(mosi, miso, sck);
+    cs_pin = new DigitalOut(cs, 1);
+    int1_pin = NULL;
+    int2_pin = NULL;
+    initialize();
+}
+#endif
+
+// Costruttore per un bus esterno (simulatore, backend Linux, ...)
+LSM6DSO16IS::LSM6DSO16IS(LSM6DSO16IS_Bus *bus) {
+    this->bus = bus;
+#ifndef LSM6DSO16IS_HOST_BUILD
+    i2c = NULL;
+    spi = NULL;
+    cs_pin = NULL;
+    int1_pin = NULL;
+    int2_pin = NULL;
+#endif
     initialize();
 }
 
 // Distruttore privato
 LSM6DSO16IS::~LSM6DSO16IS() {
     // Pulizia delle risorse, se necessario
+#ifndef LSM6DSO16IS_HOST_BUILD
     delete i2c;
     delete spi;
     delete cs_pin;
+    delete int1_pin;
+    delete int2_pin;
+#endif
 }
 
 void LSM6DSO16IS::initialize() {
+    X_isEnabled = 0;
+    G_isEnabled = 0;
+    isInitialized = 0;
+    X_Last_ODR = 104.0f;
+    G_Last_ODR = 104.0f;
+    X_Last_Mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+    G_Last_Mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+    G_Standby = LSM6DSO16IS_G_ACTIVE;
+    G_Wake_Latency_us = 0;
+    G_Sleep_Max_Idle_ms = LSM6DSO16IS_G_SLEEP_MAX_IDLE_MS;
+    config_shadow_valid = 0;
+    main_bank_selected = 1;
+    bank_fault = 0;
+#ifdef LSM6DSO16IS_THREAD_SAFE
+    bank_lock_held = 0;
+#endif
+#ifdef LSM6DSO16IS_BUS_STATS
+    bus_api = LSM6DSO16IS_API_OTHER;
+    lsm6dso16is_cycles_init();
+    Reset_Bus_Stats();
+#endif
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    drdy_edge = 0;
+    lsm6dso16is_cycles_init();
+#endif
+    ispu_boot_start_us = 0;
+    ispu_boot_time_us = 0;
+    ispu_boot_pending = 0;
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+    ispu_boot_irq = 0;
+    for (int i = 0; i < 2; i++) {
+      drdy_queue[i] = NULL;
+      drdy_captured[i] = 0;
+      drdy_dropped[i] = 0;
+    }
+#if DEVICE_SPI_ASYNCH
+    dma_active = 0;
+    dma_busy = 0;
+    dma_queue = NULL;
+    dma_blocks = 0;
+    dma_overruns = 0;
+#endif
+
     // Configurazione del sensore
     if (i2c) {
         i2c->frequency(400000); // Set I2C frequency to 400kHz
     } else if (spi) {
-        // Configurazione specifica per SPI
-        cs_pin->write(0); // Attiva il chip select se necessario
-        // Scrivi la configurazione iniziale ai registri del sensore
-        cs_pin->write(1); // Disattiva il chip select se necessario
+        // SPI modo 3, chip select inattivo alto
+        spi->format(8, 3);
+        spi->frequency(LSM6DSO16IS_SPI_FREQUENCY);
+        cs_pin->write(1);
     }
+#endif
 }
 
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::begin(void)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_BEGIN);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  LSM6DSO16IS_Config_t config;
+
+#ifndef LSM6DSO16IS_HOST_BUILD
   if (spi) {
     // Configure CS pin
     //pinMode(cs_pin, OUTPUT);
     //digitalWrite(cs_pin, HIGH);
   }
-  /* Enable register address automatically incremented during a multiple byte
-  access with a serial interface. */
-  if (auto_increment_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
-  }
+#endif
 
-  /* Enable BDU */
-  if (block_data_update_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
+  /* Register auto-increment, BDU, both sensors in power-down with 104 Hz as the
+  default output data rate, 2 g and 2000 dps full scales: the whole control block
+  is written in a few bursts, in the main bank whatever bank the sensor was left in. */
+  Get_Default_Config(&config);
+  if ((main_bank_ensure() != 0) || (Set_Config(&config) != LSM6DSO16IS_STATUS_OK)) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
 
   /* Select default output data rate. */
   X_Last_ODR = 104;
+  G_Last_ODR = 104;
 
-  /* Output data rate selection - power down. */
-  if (xl_data_rate_set(LSM6DSO16IS_XL_ODR_OFF) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+  if (ret == LSM6DSO16IS_STATUS_OK) {
+    isInitialized = 1;
   }
 
-  /* Full scale selection. */
-  if (xl_full_scale_set(LSM6DSO16IS_2g) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+  return ret;
+}
+
+
+/**
+  * @brief  Initialize the driver without restarting a sensor that is already running
+  * @note   For MCU resets without a sensor power cycle: the control block is
+  *         read in one burst and the fields owned by Config (see
+  *         Get_Config_Mask()) are compared with it. If they match, the
+  *         running configuration is adopted without any write, so sampling
+  *         continues across the reset. Otherwise only the differing registers
+  *         are written (see Apply_Config()), and the output data rate is left
+  *         untouched unless the full scale or power mode changes. The sensor
+  *         may have been left with the ISPU or sensor hub bank selected: the
+  *         main bank is selected first, written only if needed.
+  * @param  Config the expected configuration
+  * @param  Adopted 1 if the device already matched Config, 0 otherwise
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Begin_Warm(const LSM6DSO16IS_Config_t *Config, uint8_t *Adopted)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_CONFIG);
+  LSM6DSO16IS_Lock_Guard lock(*this);
+  LSM6DSO16IS_Config_Image_t image;
+  LSM6DSO16IS_Config_Image_t mask;
+  uint8_t match = 1;
+
+  *Adopted = 0;
+
+  if ((main_bank_ensure() != 0) || (config_shadow_load() != 0)) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
 
-  /* Select default output data rate. */
-  G_Last_ODR = 104;
+  /* WHO_AM_I is part of the block: no extra transaction to check the device. */
+  if (config_shadow.reg[LSM6DSO16IS_WHO_AM_I - LSM6DSO16IS_CONFIG_FIRST_REG] != LSM6DSO16IS_ID) {
+    config_shadow_valid = 0;
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-  /* Output data rate selection - power down. */
-  if (gy_data_rate_set(LSM6DSO16IS_GY_ODR_OFF) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+  /* Solo i campi della configurazione contano per il confronto */
+  Build_Config_Image(Config, &image);
+  Get_Config_Mask(&mask);
+  for (uint8_t i = 0; i < sizeof(image.reg); i++) {
+    if ((image.reg[i] & mask.reg[i]) != (config_shadow.reg[i] & mask.reg[i])) {
+      match = 0;
+      break;
+    }
   }
 
-  /* Full scale selection. */
-  if (gy_full_scale_set(LSM6DSO16IS_2000dps) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+  if (match != 0U) {
+    config_image_merge(&image);
+    config_adopt(Config, &image);
+    *Adopted = 1;
+  } else if (Apply_Config(Config) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
 
-  if (ret == LSM6DSO16IS_STATUS_OK) {
-    isInitialized = 1;
+  isInitialized = 1;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the configuration applied by begin()
+  * @param  Config the default configuration
+  */
+void LSM6DSO16IS::Get_Default_Config(LSM6DSO16IS_Config_t *Config)
+{
+  Config->xl_odr = 0.0f;
+  Config->xl_fs = 2;
+  Config->xl_mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+  Config->g_odr = 0.0f;
+  Config->g_fs = 2000;
+  Config->g_mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+  Config->bdu = PROPERTY_ENABLE;
+  Config->drdy_pulsed = PROPERTY_DISABLE;
+  Config->int1_drdy_xl = PROPERTY_DISABLE;
+  Config->int1_drdy_g = PROPERTY_DISABLE;
+  Config->int2_drdy_xl = PROPERTY_DISABLE;
+  Config->int2_drdy_g = PROPERTY_DISABLE;
+  Config->int2_drdy_temp = PROPERTY_DISABLE;
+  Config->int2_on_int1 = PROPERTY_DISABLE;
+  Config->timestamp = PROPERTY_DISABLE;
+  Config->ispu_rate = 0;
+}
+
+/**
+  * @brief  Compile a configuration into the register image of the control block
+  * @note   Register auto-increment (CTRL3_C.if_inc) is always enabled. Only
+  *         the fields selected by Get_Config_Mask() are meaningful: all the
+  *         other bits (interface setup, ISPU routing, reserved addresses) are
+  *         0 in the image and are taken from the device when it is written
+  * @param  Config the configuration
+  * @param  Image the register image, DRDY_PULSED_REG..CTRL10_C
+  */
+void LSM6DSO16IS::Build_Config_Image(const LSM6DSO16IS_Config_t *Config, LSM6DSO16IS_Config_Image_t *Image)
+{
+  lsm6dso16is_drdy_pulsed_reg_t drdy_pulsed_reg;
+  lsm6dso16is_int1_ctrl_t int1_ctrl;
+  lsm6dso16is_int2_ctrl_t int2_ctrl;
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  lsm6dso16is_ctrl4_c_t ctrl4_c;
+  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  lsm6dso16is_ctrl7_g_t ctrl7_g;
+  lsm6dso16is_ctrl9_c_t ctrl9_c;
+  lsm6dso16is_ctrl10_c_t ctrl10_c;
+  uint8_t xl_fs;
+  uint8_t g_fs;
+  uint8_t odr;
+
+  memset(&drdy_pulsed_reg, 0, sizeof(drdy_pulsed_reg));
+  memset(&int1_ctrl, 0, sizeof(int1_ctrl));
+  memset(&int2_ctrl, 0, sizeof(int2_ctrl));
+  memset(&ctrl1_xl, 0, sizeof(ctrl1_xl));
+  memset(&ctrl2_g, 0, sizeof(ctrl2_g));
+  memset(&ctrl3_c, 0, sizeof(ctrl3_c));
+  memset(&ctrl4_c, 0, sizeof(ctrl4_c));
+  memset(&ctrl6_c, 0, sizeof(ctrl6_c));
+  memset(&ctrl7_g, 0, sizeof(ctrl7_g));
+  memset(&ctrl9_c, 0, sizeof(ctrl9_c));
+  memset(&ctrl10_c, 0, sizeof(ctrl10_c));
+
+  drdy_pulsed_reg.drdy_pulsed = Config->drdy_pulsed;
+  int1_ctrl.int1_drdy_xl = Config->int1_drdy_xl;
+  int1_ctrl.int1_drdy_g = Config->int1_drdy_g;
+  int2_ctrl.int2_drdy_xl = Config->int2_drdy_xl;
+  int2_ctrl.int2_drdy_g = Config->int2_drdy_g;
+  int2_ctrl.int2_drdy_temp = Config->int2_drdy_temp;
+
+  xl_fs = lsm6dso16is_xl_fs_code(Config->xl_fs);
+  odr = (Config->xl_odr <= 0.0f) ? (uint8_t)LSM6DSO16IS_XL_ODR_OFF
+        : (uint8_t)lsm6dso16is_xl_odr_code(Config->xl_odr, Config->xl_mode);
+  ctrl1_xl.fs_xl = xl_fs;
+  ctrl1_xl.odr_xl = (odr & 0xfU);
+  ctrl6_c.xl_hm_mode = (Config->xl_mode == LSM6DSO16IS_LOW_POWER_MODE) ? 1U : 0U;
+
+  g_fs = lsm6dso16is_gy_fs_code(Config->g_fs);
+  odr = (Config->g_odr <= 0.0f) ? (uint8_t)LSM6DSO16IS_GY_ODR_OFF
+        : (uint8_t)lsm6dso16is_gy_odr_code(Config->g_odr, Config->g_mode);
+  ctrl2_g.fs_g = (g_fs & 0x3U);
+  ctrl2_g.fs_125 = (g_fs >> 4);
+  ctrl2_g.odr_g = (odr & 0xfU);
+  ctrl7_g.g_hm_mode = (Config->g_mode == LSM6DSO16IS_LOW_POWER_MODE) ? 1U : 0U;
+
+  ctrl3_c.if_inc = PROPERTY_ENABLE;
+  ctrl3_c.bdu = Config->bdu;
+  ctrl4_c.int2_on_int1 = Config->int2_on_int1;
+  ctrl9_c.ispu_rate = Config->ispu_rate;
+  ctrl10_c.timestamp_en = Config->timestamp;
+
+  memset(Image->reg, 0, sizeof(Image->reg));
+#define CONFIG_REG(r)  Image->reg[(r) - LSM6DSO16IS_CONFIG_FIRST_REG]
+  CONFIG_REG(LSM6DSO16IS_DRDY_PULSED_REG) = *(uint8_t *)&drdy_pulsed_reg;
+  CONFIG_REG(LSM6DSO16IS_INT1_CTRL) = *(uint8_t *)&int1_ctrl;
+  CONFIG_REG(LSM6DSO16IS_INT2_CTRL) = *(uint8_t *)&int2_ctrl;
+  CONFIG_REG(LSM6DSO16IS_CTRL1_XL) = *(uint8_t *)&ctrl1_xl;
+  CONFIG_REG(LSM6DSO16IS_CTRL2_G) = *(uint8_t *)&ctrl2_g;
+  CONFIG_REG(LSM6DSO16IS_CTRL3_C) = *(uint8_t *)&ctrl3_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL4_C) = *(uint8_t *)&ctrl4_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL6_C) = *(uint8_t *)&ctrl6_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL7_G) = *(uint8_t *)&ctrl7_g;
+  CONFIG_REG(LSM6DSO16IS_CTRL9_C) = *(uint8_t *)&ctrl9_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL10_C) = *(uint8_t *)&ctrl10_c;
+#undef CONFIG_REG
+}
+
+/**
+  * @brief  Get the register bits owned by LSM6DSO16IS_Config_t
+  * @note   Bits outside the mask are never changed by Set_Config(),
+  *         Apply_Config() or Begin_Warm()
+  * @param  Mask the owned bits of each register, DRDY_PULSED_REG..CTRL10_C
+  */
+void LSM6DSO16IS::Get_Config_Mask(LSM6DSO16IS_Config_Image_t *Mask)
+{
+  lsm6dso16is_drdy_pulsed_reg_t drdy_pulsed_reg;
+  lsm6dso16is_int1_ctrl_t int1_ctrl;
+  lsm6dso16is_int2_ctrl_t int2_ctrl;
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  lsm6dso16is_ctrl4_c_t ctrl4_c;
+  lsm6dso16is_ctrl5_c_t ctrl5_c;
+  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  lsm6dso16is_ctrl7_g_t ctrl7_g;
+  lsm6dso16is_ctrl9_c_t ctrl9_c;
+  lsm6dso16is_ctrl10_c_t ctrl10_c;
+
+  memset(&drdy_pulsed_reg, 0, sizeof(drdy_pulsed_reg));
+  memset(&int1_ctrl, 0, sizeof(int1_ctrl));
+  memset(&int2_ctrl, 0, sizeof(int2_ctrl));
+  memset(&ctrl1_xl, 0, sizeof(ctrl1_xl));
+  memset(&ctrl2_g, 0, sizeof(ctrl2_g));
+  memset(&ctrl3_c, 0, sizeof(ctrl3_c));
+  memset(&ctrl4_c, 0, sizeof(ctrl4_c));
+  memset(&ctrl5_c, 0, sizeof(ctrl5_c));
+  memset(&ctrl6_c, 0, sizeof(ctrl6_c));
+  memset(&ctrl7_g, 0, sizeof(ctrl7_g));
+  memset(&ctrl9_c, 0, sizeof(ctrl9_c));
+  memset(&ctrl10_c, 0, sizeof(ctrl10_c));
+
+  drdy_pulsed_reg.drdy_pulsed = 1U;
+  int1_ctrl.int1_drdy_xl = 1U;
+  int1_ctrl.int1_drdy_g = 1U;
+  int2_ctrl.int2_drdy_xl = 1U;
+  int2_ctrl.int2_drdy_g = 1U;
+  int2_ctrl.int2_drdy_temp = 1U;
+  ctrl1_xl.fs_xl = 0x3U;
+  ctrl1_xl.odr_xl = 0xFU;
+  ctrl2_g.fs_125 = 1U;
+  ctrl2_g.fs_g = 0x3U;
+  ctrl2_g.odr_g = 0xFU;
+  ctrl3_c.if_inc = 1U;
+  ctrl3_c.bdu = 1U;
+  ctrl4_c.int2_on_int1 = 1U;
+  ctrl4_c.sleep_g = 1U;
+  /* Il self-test viene sempre disattivato dalla configurazione */
+  ctrl5_c.st_xl = 0x3U;
+  ctrl5_c.st_g = 0x3U;
+  ctrl6_c.xl_hm_mode = 1U;
+  ctrl7_g.g_hm_mode = 1U;
+  ctrl9_c.ispu_rate = 0xFU;
+  ctrl10_c.timestamp_en = 1U;
+
+  memset(Mask->reg, 0, sizeof(Mask->reg));
+#define CONFIG_REG(r)  Mask->reg[(r) - LSM6DSO16IS_CONFIG_FIRST_REG]
+  CONFIG_REG(LSM6DSO16IS_DRDY_PULSED_REG) = *(uint8_t *)&drdy_pulsed_reg;
+  CONFIG_REG(LSM6DSO16IS_INT1_CTRL) = *(uint8_t *)&int1_ctrl;
+  CONFIG_REG(LSM6DSO16IS_INT2_CTRL) = *(uint8_t *)&int2_ctrl;
+  CONFIG_REG(LSM6DSO16IS_CTRL1_XL) = *(uint8_t *)&ctrl1_xl;
+  CONFIG_REG(LSM6DSO16IS_CTRL2_G) = *(uint8_t *)&ctrl2_g;
+  CONFIG_REG(LSM6DSO16IS_CTRL3_C) = *(uint8_t *)&ctrl3_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL4_C) = *(uint8_t *)&ctrl4_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL5_C) = *(uint8_t *)&ctrl5_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL6_C) = *(uint8_t *)&ctrl6_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL7_G) = *(uint8_t *)&ctrl7_g;
+  CONFIG_REG(LSM6DSO16IS_CTRL9_C) = *(uint8_t *)&ctrl9_c;
+  CONFIG_REG(LSM6DSO16IS_CTRL10_C) = *(uint8_t *)&ctrl10_c;
+#undef CONFIG_REG
+}
+
+/**
+  * @brief  Write a whole configuration to the control block
+  * @note   The register image is merged with the bits not owned by the
+  *         configuration (read in one burst the first time) and written in
+  *         contiguous bursts, skipping the reserved and read-only addresses:
+  *         four transactions instead of a read-modify-write per field.
+  *         Self-test and gyroscope sleep are cleared.
+  * @param  Config the configuration
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_Config(const LSM6DSO16IS_Config_t *Config)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_CONFIG);
+  LSM6DSO16IS_Lock_Guard lock(*this);
+  LSM6DSO16IS_Config_Image_t image;
+
+  if ((config_shadow_valid == 0U) && (config_shadow_load() != 0)) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
 
-  return ret;
+  Build_Config_Image(Config, &image);
+  config_image_merge(&image);
+
+  if (config_image_write(&image, LSM6DSO16IS_CONFIG_FIRST_REG, LSM6DSO16IS_CONFIG_LAST_REG) != 0) {
+    config_shadow_valid = 0;
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  config_adopt(Config, &image);
+
+  return LSM6DSO16IS_STATUS_OK;
 }
 
+/**
+  * @brief  Apply a configuration writing only the registers that change
+  * @note   The new register image is compared with the shadow copy of the
+  *         control block (read in one burst the first time), after merging
+  *         the bits not owned by the configuration. Only the changed bytes
+  *         are written, in contiguous bursts. A sensor whose full scale or
+  *         power mode changes is put in power-down first, and the output data
+  *         rates are written last, so that no sample is produced with a
+  *         half-applied configuration. Nothing is written if nothing changes.
+  * @param  Config the configuration
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Apply_Config(const LSM6DSO16IS_Config_t *Config)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_CONFIG);
+  LSM6DSO16IS_Lock_Guard lock(*this);
+  LSM6DSO16IS_Config_Image_t image;
+  LSM6DSO16IS_Config_Image_t step;
+  uint8_t xl = LSM6DSO16IS_CTRL1_XL - LSM6DSO16IS_CONFIG_FIRST_REG;
+  uint8_t g = LSM6DSO16IS_CTRL2_G - LSM6DSO16IS_CONFIG_FIRST_REG;
+  uint8_t xl_mode = LSM6DSO16IS_CTRL6_C - LSM6DSO16IS_CONFIG_FIRST_REG;
+  uint8_t g_mode = LSM6DSO16IS_CTRL7_G - LSM6DSO16IS_CONFIG_FIRST_REG;
+  int32_t ret = 0;
+
+  if ((config_shadow_valid == 0U) && (config_shadow_load() != 0)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  Build_Config_Image(Config, &image);
+  config_image_merge(&image);
+
+  /* ODR in the high nibble of CTRL1_XL / CTRL2_G, full scale in the low one. */
+  step = config_shadow;
+  if (((config_shadow.reg[xl] & 0xF0U) != 0U) &&
+      ((((config_shadow.reg[xl] ^ image.reg[xl]) & 0x0FU) != 0U) || (config_shadow.reg[xl_mode] != image.reg[xl_mode]))) {
+    step.reg[xl] = (uint8_t)(config_shadow.reg[xl] & 0x0FU);
+  }
+  if (((config_shadow.reg[g] & 0xF0U) != 0U) &&
+      ((((config_shadow.reg[g] ^ image.reg[g]) & 0x0FU) != 0U) || (config_shadow.reg[g_mode] != image.reg[g_mode]))) {
+    step.reg[g] = (uint8_t)(config_shadow.reg[g] & 0x0FU);
+  }
+
+  ret = config_diff_write(&step, LSM6DSO16IS_CTRL1_XL, LSM6DSO16IS_CTRL2_G);
+  if (ret == 0) {
+    ret = config_diff_write(&image, LSM6DSO16IS_CONFIG_FIRST_REG, LSM6DSO16IS_WHO_AM_I);
+  }
+  if (ret == 0) {
+    ret = config_diff_write(&image, LSM6DSO16IS_CTRL3_C, LSM6DSO16IS_CONFIG_LAST_REG);
+  }
+  if (ret == 0) {
+    ret = config_diff_write(&image, LSM6DSO16IS_CTRL1_XL, LSM6DSO16IS_CTRL2_G);
+  }
+  if (ret != 0) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  config_adopt(Config, &image);
+
+  return LSM6DSO16IS_STATUS_OK;
+}
 
 bool LSM6DSO16IS::isConnected() {
     uint8_t who_am_i;
@@ -127,7 +516,264 @@ void LSM6DSO16IS::set_SDO_SAO_TO_VCC(){
     LSM6DSO16IS::lsm6ds01tis_8bit_address = 0x0A << 1;
 }
 
+/**
+  * @brief  Take the driver lock
+  * @note   With LSM6DSO16IS_THREAD_SAFE every register transaction takes the
+  *         lock for its own duration only, while a sequence that switches
+  *         FUNC_CFG_ACCESS away from the main bank holds it until the main bank
+  *         is selected again, so that no other thread reads the ISPU or
+  *         sensor hub registers in place of the output registers. Lock() can
+  *         be nested and is a no-op without LSM6DSO16IS_THREAD_SAFE.
+  */
+void LSM6DSO16IS::Lock(void)
+{
+#ifdef LSM6DSO16IS_THREAD_SAFE
+  bus_mutex.lock();
+#endif
+}
+
+/**
+  * @brief  Release the driver lock taken by Lock()
+  */
+void LSM6DSO16IS::Unlock(void)
+{
+#ifdef LSM6DSO16IS_THREAD_SAFE
+  bus_mutex.unlock();
+#endif
+}
+
+/**
+  * @brief  Get the bus cost of a public call since the last Reset_Bus_Stats()
+  * @note   Needs LSM6DSO16IS_BUS_STATS. Transactions and bytes include the
+  *         register accesses of the nested calls and bank switches; time is
+  *         measured around each transaction, lock wait excluded. A public
+  *         call holds the bus lock while it is charged, so with
+  *         LSM6DSO16IS_THREAD_SAFE concurrent calls are counted separately.
+  * @param  Api the public call
+  * @param  Stats calls, transactions, bytes and bus time
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_Bus_Stats(LSM6DSO16IS_Bus_Api_t Api, LSM6DSO16IS_Bus_Stats_t *Stats)
+{
+#ifdef LSM6DSO16IS_BUS_STATS
+  if ((uint32_t)Api >= (uint32_t)LSM6DSO16IS_API_COUNT) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  Lock();
+  *Stats = bus_stats[Api];
+  Unlock();
+  Stats->time_us = (Stats->cycles * 1000000U) / lsm6dso16is_cycles_hz();
+
+  return LSM6DSO16IS_STATUS_OK;
+#else
+  (void)Api;
+  (void)Stats;
+  return LSM6DSO16IS_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Clear the bus cost of all the public calls
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Reset_Bus_Stats(void)
+{
+#ifdef LSM6DSO16IS_BUS_STATS
+  Lock();
+  for (uint8_t i = 0; i < (uint8_t)LSM6DSO16IS_API_COUNT; i++) {
+    bus_stats[i].calls = 0;
+    bus_stats[i].transactions = 0;
+    bus_stats[i].bytes = 0;
+    bus_stats[i].cycles = 0;
+    bus_stats[i].time_us = 0;
+  }
+  Unlock();
+
+  return LSM6DSO16IS_STATUS_OK;
+#else
+  return LSM6DSO16IS_STATUS_ERROR;
+#endif
+}
+
+#ifdef LSM6DSO16IS_BUS_TIMING
+void LSM6DSO16IS::bus_account(uint16_t transactions, uint32_t bytes, uint32_t start)
+{
+    uint32_t cycles = lsm6dso16is_cycles() - start;
+
+#ifdef LSM6DSO16IS_BUS_STATS
+    LSM6DSO16IS_Bus_Stats_t *stats = &bus_stats[bus_api];
+
+    stats->cycles += cycles;
+    stats->transactions += transactions;
+    stats->bytes += bytes;
+#else
+    (void)transactions;
+    (void)bytes;
+#endif
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    latency[LSM6DSO16IS_LATENCY_BUS_TRANSFER].Record(cycles);
+#endif
+}
+#endif
+
+/**
+  * @brief  Copy a latency histogram of the sample path
+  * @note   Needs LSM6DSO16IS_LATENCY_HIST. Durations are in lsm6dso16is_cycles()
+  *         ticks, Snapshot->hz gives their frequency. Bus transfer covers every
+  *         register transaction, DRDY to read start is measured from
+  *         Notify_DRDY() to the next read of the output registers, conversion
+  *         from the sensitivity lookup to the scaled values of
+  *         Get_X_Axes()/Get_G_Axes(), the lookup itself excluded.
+  * @param  Which the latency
+  * @param  Snapshot the copy
+  * @param  Reset 1 to clear the histogram
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_Latency_Histogram(LSM6DSO16IS_Latency_t Which,
+                                                          LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Reset)
+{
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  if ((uint32_t)Which >= (uint32_t)LSM6DSO16IS_LATENCY_COUNT) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  latency[Which].Snapshot(Snapshot, Reset);
+
+  return LSM6DSO16IS_STATUS_OK;
+#else
+  (void)Which;
+  (void)Snapshot;
+  (void)Reset;
+  return LSM6DSO16IS_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Get the count, p50, p99 and max of a latency, in ns
+  * @note   Needs LSM6DSO16IS_LATENCY_HIST
+  * @param  Which the latency
+  * @param  Summary the summary
+  * @param  Reset 1 to clear the histogram
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_Latency_Summary(LSM6DSO16IS_Latency_t Which,
+                                                        LSM6DSO16IS_Latency_Summary_t *Summary, uint8_t Reset)
+{
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  LSM6DSO16IS_Histogram_Snapshot_t snapshot;
+
+  if (Get_Latency_Histogram(Which, &snapshot, Reset) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  LSM6DSO16IS_Histogram::Summarize(&snapshot, Summary);
+
+  return LSM6DSO16IS_STATUS_OK;
+#else
+  (void)Which;
+  (void)Summary;
+  (void)Reset;
+  return LSM6DSO16IS_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Clear all the latency histograms
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Reset_Latency_Histograms(void)
+{
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  for (uint8_t i = 0; i < (uint8_t)LSM6DSO16IS_LATENCY_COUNT; i++) {
+    latency[i].Reset();
+  }
+
+  return LSM6DSO16IS_STATUS_OK;
+#else
+  return LSM6DSO16IS_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Mark a data-ready edge, start of the DRDY to read start latency
+  * @note   Called by the INT1/INT2 interrupt handlers on Mbed for the pins
+  *         with DRDY or DMA capture, the ISPU boot edge excluded; on hosts
+  *         call it from the GPIO or simulator edge handler of a data-ready
+  *         line. ISR safe, a no-op without LSM6DSO16IS_LATENCY_HIST.
+  */
+void LSM6DSO16IS::Notify_DRDY(void)
+{
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  uint32_t now = lsm6dso16is_cycles();
+
+  drdy_edge.store((now != 0U) ? now : 1U, std::memory_order_relaxed);
+#endif
+}
+
+#ifdef LSM6DSO16IS_LATENCY_HIST
+void LSM6DSO16IS::drdy_read_start(uint8_t reg)
+{
+    // Solo le letture dei registri di uscita del banco principale chiudono l'intervallo
+    if ((main_bank_selected != 0U) && (reg >= LSM6DSO16IS_OUT_TEMP_L) && (reg <= LSM6DSO16IS_OUTZ_H_A) &&
+        (drdy_edge.load(std::memory_order_relaxed) != 0U)) {
+        uint32_t edge = drdy_edge.exchange(0U, std::memory_order_relaxed);
+
+        if (edge != 0U) {
+            latency[LSM6DSO16IS_LATENCY_DRDY_TO_READ].Record(lsm6dso16is_cycles() - edge);
+        }
+    }
+}
+#endif
+
 bool LSM6DSO16IS::readRegister(uint8_t reg, uint8_t *value, uint16_t len) {
+    Lock();
+    // FUNC_CFG_ACCESS e' visibile da ogni banco e serve al ripristino
+    if ((reg != LSM6DSO16IS_FUNC_CFG_ACCESS) && (bank_fault_recover() != 0)) {
+        Unlock();
+        return 1;
+    }
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    drdy_read_start(reg);
+#endif
+#ifdef LSM6DSO16IS_BUS_TIMING
+    uint32_t start = lsm6dso16is_cycles();
+#endif
+    bool ret = readBus(reg, value, len);
+#ifdef LSM6DSO16IS_BUS_TIMING
+    bus_account(1, len, start);
+#endif
+    Unlock();
+
+    return ret;
+}
+
+bool LSM6DSO16IS::readBus(uint8_t reg, uint8_t *value, uint16_t len) {
+    if (bus != NULL) {
+        return (bus->read(reg, value, len) != 0);
+    }
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+    if (spi != NULL) {
+        // bit 7 del primo byte: lettura
+        uint8_t cmd = reg | LSM6DSO16IS_SPI_READ;
+        InterruptIn *paused;
+
+        if (dma_pause(&paused) != 0) {
+            dma_resume(paused);
+            return 1;
+        }
+
+        spi->lock();
+        cs_pin->write(0);
+        spi->write((const char*)&cmd, 1, NULL, 0);
+        spi->write(NULL, 0, (char*)value, len);
+        cs_pin->write(1);
+        spi->unlock();
+        dma_resume(paused);
+        return 0;
+    }
+
     if (i2c->write(lsm6ds01tis_8bit_address, (const char*)&reg, 1) != 0)
         return 1;
     if (i2c->read(lsm6ds01tis_8bit_address, (char*) value, len) != 0)
@@ -135,10 +781,62 @@ bool LSM6DSO16IS::readRegister(uint8_t reg, uint8_t *value, uint16_t len) {
 
     bool ret = 0;
     return ret;
+#else
+    return 1;
+#endif
 }
 
 bool LSM6DSO16IS::writeRegister(uint8_t reg, const uint8_t *value, uint16_t len) {
-    uint8_t data[len + 1];
+    Lock();
+    if ((reg != LSM6DSO16IS_FUNC_CFG_ACCESS) && (bank_fault_recover() != 0)) {
+        Unlock();
+        return 1;
+    }
+#ifdef LSM6DSO16IS_BUS_TIMING
+    uint32_t start = lsm6dso16is_cycles();
+#endif
+    bool ret = writeBus(reg, value, len);
+#ifdef LSM6DSO16IS_BUS_TIMING
+    bus_account(1, len, start);
+#endif
+
+    // mantiene allineata la copia dei registri di controllo
+    config_shadow_track(reg, value, len, ret);
+    Unlock();
+
+    return ret;
+}
+
+bool LSM6DSO16IS::writeBus(uint8_t reg, const uint8_t *value, uint16_t len) {
+    if (bus != NULL) {
+        return (bus->write(reg, value, len) != 0);
+    }
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+    if (spi != NULL) {
+        uint8_t cmd = reg & (uint8_t)~LSM6DSO16IS_SPI_READ;
+        InterruptIn *paused;
+
+        if (dma_pause(&paused) != 0) {
+            dma_resume(paused);
+            return 1;
+        }
+
+        spi->lock();
+        cs_pin->write(0);
+        spi->write((const char*)&cmd, 1, NULL, 0);
+        spi->write((const char*)value, len, NULL, 0);
+        cs_pin->write(1);
+        spi->unlock();
+        dma_resume(paused);
+        return 0;
+    }
+
+    // buffer a capacita' fissa: registro + al massimo LSM6DSO16IS_MAX_WRITE_LEN byte
+    uint8_t data[LSM6DSO16IS_MAX_WRITE_LEN + 1];
+
+    if (len > LSM6DSO16IS_MAX_WRITE_LEN)
+        return 1;
     data[0] = reg; // inserisci il byte di registro nella prima posizione
 
     // copia i dati da value a data a partire dalla seconda posizione
@@ -150,6 +848,9 @@ bool LSM6DSO16IS::writeRegister(uint8_t reg, const uint8_t *value, uint16_t len)
     if (i2c->write(lsm6ds01tis_8bit_address, (const char*)data, len + 1) != 0)
         return 1;
     return 0;
+#else
+    return 1;
+#endif
 }
 
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::ReadID(uint8_t *val)
@@ -163,6 +864,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::ReadID(uint8_t *val)
 
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_X(void)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ENABLE_X);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_xl_data_rate_t new_odr;
 
@@ -170,16 +872,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_X(void)
   if (X_isEnabled == 1U) {
     ret = LSM6DSO16IS_STATUS_OK;
   } else {
-    new_odr = (X_Last_ODR <=   12.5f) ? LSM6DSO16IS_XL_ODR_AT_12Hz5_HP
-              : (X_Last_ODR <=   26.0f) ? LSM6DSO16IS_XL_ODR_AT_26H_HP
-              : (X_Last_ODR <=   52.0f) ? LSM6DSO16IS_XL_ODR_AT_52Hz_HP
-              : (X_Last_ODR <=  104.0f) ? LSM6DSO16IS_XL_ODR_AT_104Hz_HP
-              : (X_Last_ODR <=  208.0f) ? LSM6DSO16IS_XL_ODR_AT_208Hz_HP
-              : (X_Last_ODR <=  416.0f) ? LSM6DSO16IS_XL_ODR_AT_416Hz_HP
-              : (X_Last_ODR <=  833.0f) ? LSM6DSO16IS_XL_ODR_AT_833Hz_HP
-              : (X_Last_ODR <= 1667.0f) ? LSM6DSO16IS_XL_ODR_AT_1667Hz_HP
-              : (X_Last_ODR <= 3333.0f) ? LSM6DSO16IS_XL_ODR_AT_3333Hz_HP
-              :                    LSM6DSO16IS_XL_ODR_AT_6667Hz_HP;
+    new_odr = lsm6dso16is_xl_odr_code(X_Last_ODR, X_Last_Mode);
 
     /* Output data rate selection. */
     if (xl_data_rate_set(new_odr) != LSM6DSO16IS_STATUS_OK) {
@@ -197,6 +890,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_X(void)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Disable_X(void)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_DISABLE_X);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
 
   /* Check if the component is already disabled */
@@ -225,6 +919,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Disable_X(void)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR(float_t Odr)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_X_ODR);
   LSM6DSO16ISStatusTypeDef ret;
 
   /* Check if the component is enabled */
@@ -237,6 +932,34 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR(float_t Odr)
   return ret;
 }
 
+/**
+  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate from a register code
+  * @note   No float comparison at run time: build the code with
+  *         lsm6dso16is_xl_odr_const(), which is resolved by the compiler
+  * @param  Code the output data rate code, including the power mode
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR(lsm6dso16is_xl_data_rate_t Code)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_X_ODR);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  float_t odr = lsm6dso16is_xl_odr_hz((uint8_t)Code);
+
+  if (odr <= 0.0f) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  X_Last_ODR = odr;
+  X_Last_Mode = (((uint8_t)Code & LSM6DSO16IS_ODR_LP_FLAG) != 0U) ? LSM6DSO16IS_LOW_POWER_MODE
+                : LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+
+  if ((X_isEnabled == 1U) && (xl_data_rate_set(Code) != LSM6DSO16IS_STATUS_OK)) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
 
 /**
   * @brief  Get the LSM6DSO16IS accelerometer sensor full scale
@@ -253,27 +976,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_FS(int32_t *FullScale)
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
 
-  switch (fs_low_level) {
-    case LSM6DSO16IS_2g:
-      *FullScale =  2;
-      break;
-
-    case LSM6DSO16IS_4g:
-      *FullScale =  4;
-      break;
-
-    case LSM6DSO16IS_8g:
-      *FullScale =  8;
-      break;
-
-    case LSM6DSO16IS_16g:
-      *FullScale = 16;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
-  }
+  *FullScale = lsm6dso16is_xl_fs_g[(uint8_t)fs_low_level & 0x3U];
 
   return ret;
 }
@@ -290,60 +993,18 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_ODR(float_t *Odr)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_xl_data_rate_t odr_low_level;
+  float_t odr;
 
   /* Get current output data rate. */
   if (xl_data_rate_get(&odr_low_level) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
 
-  switch (odr_low_level) {
-    case LSM6DSO16IS_XL_ODR_OFF:
-      *Odr = 0.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_12Hz5_HP:
-      *Odr = 12.5f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_26H_HP:
-      *Odr = 26.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_52Hz_HP:
-      *Odr = 52.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_104Hz_HP:
-      *Odr = 104.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_208Hz_HP:
-      *Odr = 208.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_416Hz_HP:
-      *Odr = 416.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_833Hz_HP:
-      *Odr = 833.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_1667Hz_HP:
-      *Odr = 1667.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_3333Hz_HP:
-      *Odr = 3333.0f;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_6667Hz_HP:
-      *Odr = 6667.0f;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
+  odr = lsm6dso16is_xl_odr_hz((uint8_t)odr_low_level);
+  if (odr < 0.0f) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    *Odr = odr;
   }
 
   return ret;
@@ -365,30 +1026,10 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_Sensitivity(float_t *Sensitivity)
   }
 
   /* Store the Sensitivity based on actual full scale. */
-  switch (full_scale) {
-    case LSM6DSO16IS_2g:
-      *Sensitivity = LSM6DSO16IS_ACC_SENSITIVITY_FS_2G;
-      break;
+  *Sensitivity = lsm6dso16is_xl_sensitivity[(uint8_t)full_scale & 0x3U];
 
-    case LSM6DSO16IS_4g:
-      *Sensitivity = LSM6DSO16IS_ACC_SENSITIVITY_FS_4G;
-      break;
-
-    case LSM6DSO16IS_8g:
-      *Sensitivity = LSM6DSO16IS_ACC_SENSITIVITY_FS_8G;
-      break;
-
-    case LSM6DSO16IS_16g:
-      *Sensitivity = LSM6DSO16IS_ACC_SENSITIVITY_FS_16G;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
-  }
-
-  return ret;
-}
+  return ret;
+}
 
 /**
   * @brief  Set the LSM6DSO16IS accelerometer sensor full scale
@@ -397,13 +1038,11 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_Sensitivity(float_t *Sensitivity)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_FS(int32_t FullScale)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_X_FS);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_xl_full_scale_t new_fs;
 
-  new_fs = (FullScale <= 2) ? LSM6DSO16IS_2g
-           : (FullScale <= 4) ? LSM6DSO16IS_4g
-           : (FullScale <= 8) ? LSM6DSO16IS_8g
-           :                    LSM6DSO16IS_16g;
+  new_fs = lsm6dso16is_xl_fs_code(FullScale);
 
   if (xl_full_scale_set(new_fs) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
@@ -420,6 +1059,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_FS(int32_t FullScale)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_AxesRaw(int32_t *Value)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_GET_X_AXES);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   int16_t data_raw[3];
 
@@ -444,6 +1084,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_AxesRaw(int32_t *Value)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_Axes(float *Acceleration)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_GET_X_AXES);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   int16_t data_raw[3];
   float_t sensitivity = 0.0f;
@@ -457,11 +1098,17 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_Axes(float *Acceleration)
   if (Get_X_Sensitivity(&sensitivity) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  uint32_t start = lsm6dso16is_cycles();
+#endif
 
   /* Calculate the data. */
   Acceleration[0] = ((float_t)((float_t)data_raw[0] * sensitivity));
   Acceleration[1] = ((float_t)((float_t)data_raw[1] * sensitivity));
   Acceleration[2] = ((float_t)((float_t)data_raw[2] * sensitivity));
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  latency[LSM6DSO16IS_LATENCY_CONVERSION].Record(lsm6dso16is_cycles() - start);
+#endif
 
   return ret;
 }
@@ -473,6 +1120,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_Axes(float *Acceleration)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_G(void)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ENABLE_G);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_gy_data_rate_t new_odr;
 
@@ -480,22 +1128,15 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_G(void)
   if (G_isEnabled == 1U) {
     ret = LSM6DSO16IS_STATUS_OK;
   } else {
-    new_odr = (G_Last_ODR <=   12.5f) ? LSM6DSO16IS_GY_ODR_AT_12Hz5_HP
-              : (G_Last_ODR <=   26.0f) ? LSM6DSO16IS_GY_ODR_AT_26H_HP
-              : (G_Last_ODR <=   52.0f) ? LSM6DSO16IS_GY_ODR_AT_52Hz_HP
-              : (G_Last_ODR <=  104.0f) ? LSM6DSO16IS_GY_ODR_AT_104Hz_HP
-              : (G_Last_ODR <=  208.0f) ? LSM6DSO16IS_GY_ODR_AT_208Hz_HP
-              : (G_Last_ODR <=  416.0f) ? LSM6DSO16IS_GY_ODR_AT_416Hz_HP
-              : (G_Last_ODR <=  833.0f) ? LSM6DSO16IS_GY_ODR_AT_833Hz_HP
-              : (G_Last_ODR <= 1667.0f) ? LSM6DSO16IS_GY_ODR_AT_1667Hz_HP
-              : (G_Last_ODR <= 3333.0f) ? LSM6DSO16IS_GY_ODR_AT_3333Hz_HP
-              :                    LSM6DSO16IS_GY_ODR_AT_6667Hz_HP;
+    new_odr = lsm6dso16is_gy_odr_code(G_Last_ODR, G_Last_Mode);
     /* Output data rate selection. */
     if (gy_data_rate_set(new_odr) != LSM6DSO16IS_STATUS_OK) {
       ret = LSM6DSO16IS_STATUS_ERROR;
     }
 
     G_isEnabled = 1;
+    /* Running again: a power-down chosen by Standby_G() is over. */
+    G_Standby = LSM6DSO16IS_G_ACTIVE;
   }
 
   return ret;
@@ -508,6 +1149,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_G(void)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Disable_G(void)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_DISABLE_G);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
 
   /* Check if the component is already disabled */
@@ -522,6 +1164,11 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Disable_G(void)
     if (gy_data_rate_set(LSM6DSO16IS_GY_ODR_OFF) != LSM6DSO16IS_STATUS_OK) {
       ret = LSM6DSO16IS_STATUS_ERROR;
     }
+    /* Leave sleep mode, otherwise the next Enable_G() would produce no output. */
+    if ((G_Standby == LSM6DSO16IS_G_SLEEP) && (gy_sleep_mode_set(PROPERTY_DISABLE) != LSM6DSO16IS_STATUS_OK)) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+    G_Standby = LSM6DSO16IS_G_ACTIVE;
 
     G_isEnabled = 0;
   }
@@ -545,31 +1192,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Sensitivity(float_t *Sensitivity)
   }
 
   /* Store the sensitivity based on actual full scale. */
-  switch (full_scale) {
-    case LSM6DSO16IS_125dps:
-      *Sensitivity = LSM6DSO16IS_GYRO_SENSITIVITY_FS_125DPS;
-      break;
-
-    case LSM6DSO16IS_250dps:
-      *Sensitivity = LSM6DSO16IS_GYRO_SENSITIVITY_FS_250DPS;
-      break;
-
-    case LSM6DSO16IS_500dps:
-      *Sensitivity = LSM6DSO16IS_GYRO_SENSITIVITY_FS_500DPS;
-      break;
-
-    case LSM6DSO16IS_1000dps:
-      *Sensitivity = LSM6DSO16IS_GYRO_SENSITIVITY_FS_1000DPS;
-      break;
-
-    case LSM6DSO16IS_2000dps:
-      *Sensitivity = LSM6DSO16IS_GYRO_SENSITIVITY_FS_2000DPS;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
-  }
+  *Sensitivity = lsm6dso16is_gy_sensitivity[lsm6dso16is_gy_fs_index(full_scale)];
 
   return ret;
 }
@@ -584,60 +1207,18 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_ODR(float_t *Odr)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_gy_data_rate_t odr_low_level;
+  float_t odr;
 
   /* Get current output data rate. */
   if (gy_data_rate_get(&odr_low_level) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
 
-  switch (odr_low_level) {
-    case LSM6DSO16IS_GY_ODR_OFF:
-      *Odr = 0.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_12Hz5_HP:
-      *Odr = 12.5f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_26H_HP:
-      *Odr = 26.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_52Hz_HP:
-      *Odr = 52.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_104Hz_HP:
-      *Odr = 104.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_208Hz_HP:
-      *Odr = 208.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_416Hz_HP:
-      *Odr = 416.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_833Hz_HP:
-      *Odr = 833.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_1667Hz_HP:
-      *Odr =  1667.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_3333Hz_HP:
-      *Odr =  3333.0f;
-      break;
-
-    case LSM6DSO16IS_GY_ODR_AT_6667Hz_HP:
-      *Odr =  6667.0f;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
+  odr = lsm6dso16is_gy_odr_hz((uint8_t)odr_low_level);
+  if (odr < 0.0f) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    *Odr = odr;
   }
 
   return ret;
@@ -650,6 +1231,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_ODR(float_t *Odr)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR(float_t Odr)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_G_ODR);
   LSM6DSO16ISStatusTypeDef ret;
 
   /* Check if the component is enabled */
@@ -662,6 +1244,34 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR(float_t Odr)
   return ret;
 }
 
+/**
+  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate from a register code
+  * @note   No float comparison at run time: build the code with
+  *         lsm6dso16is_gy_odr_const(), which is resolved by the compiler
+  * @param  Code the output data rate code, including the power mode
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR(lsm6dso16is_gy_data_rate_t Code)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_G_ODR);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  float_t odr = lsm6dso16is_gy_odr_hz((uint8_t)Code);
+
+  if (odr <= 0.0f) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  G_Last_ODR = odr;
+  G_Last_Mode = (((uint8_t)Code & LSM6DSO16IS_ODR_LP_FLAG) != 0U) ? LSM6DSO16IS_LOW_POWER_MODE
+                : LSM6DSO16IS_HIGH_PERFORMANCE_MODE;
+
+  if ((G_isEnabled == 1U) && (gy_data_rate_set(Code) != LSM6DSO16IS_STATUS_OK)) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
 
 /**
   * @brief  Get the LSM6DSO16IS gyroscope sensor full scale
@@ -678,31 +1288,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_FS(int32_t  *FullScale)
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
 
-  switch (fs_low_level) {
-    case LSM6DSO16IS_125dps:
-      *FullScale =  125;
-      break;
-
-    case LSM6DSO16IS_250dps:
-      *FullScale =  250;
-      break;
-
-    case LSM6DSO16IS_500dps:
-      *FullScale =  500;
-      break;
-
-    case LSM6DSO16IS_1000dps:
-      *FullScale = 1000;
-      break;
-
-    case LSM6DSO16IS_2000dps:
-      *FullScale = 2000;
-      break;
-
-    default:
-      ret = LSM6DSO16IS_STATUS_ERROR;
-      break;
-  }
+  *FullScale = lsm6dso16is_gy_fs_dps[lsm6dso16is_gy_fs_index(fs_low_level)];
 
   return ret;
 }
@@ -715,14 +1301,11 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_FS(int32_t  *FullScale)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_FS(int32_t FullScale)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_G_FS);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_gy_full_scale_t new_fs;
 
-  new_fs = (FullScale <= 125)  ? LSM6DSO16IS_125dps
-           : (FullScale <= 250)  ? LSM6DSO16IS_250dps
-           : (FullScale <= 500)  ? LSM6DSO16IS_500dps
-           : (FullScale <= 1000) ? LSM6DSO16IS_1000dps
-           :                       LSM6DSO16IS_2000dps;
+  new_fs = lsm6dso16is_gy_fs_code(FullScale);
 
   if (gy_full_scale_set(new_fs) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
@@ -738,6 +1321,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_FS(int32_t FullScale)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_AxesRaw(int32_t *Value)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_GET_G_AXES);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   int16_t data_raw[3];
 
@@ -761,6 +1345,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_AxesRaw(int32_t *Value)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Axes(float *AngularRate)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_GET_G_AXES);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   int16_t data_raw[3];
   float_t sensitivity;
@@ -774,11 +1359,17 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Axes(float *AngularRate)
   if (Get_G_Sensitivity(&sensitivity) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  uint32_t start = lsm6dso16is_cycles();
+#endif
 
   /* Calculate the data. */
   AngularRate[0] = (float)((float_t)((float_t)data_raw[0] * sensitivity));
   AngularRate[1] = (float)((float_t)((float_t)data_raw[1] * sensitivity));
   AngularRate[2] = (float)((float_t)((float_t)data_raw[2] * sensitivity));
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  latency[LSM6DSO16IS_LATENCY_CONVERSION].Record(lsm6dso16is_cycles() - start);
+#endif
 
   return ret;
 }
@@ -791,6 +1382,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Axes(float *AngularRate)
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_Reg(uint8_t Reg, uint8_t *Data)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_READ_REG);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   if (readRegister(Reg, Data, 1) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
@@ -799,6 +1391,75 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_Reg(uint8_t Reg, uint8_t *Data)
   return ret;
 }
 
+/**
+  * @brief  Get consecutive LSM6DSO16IS registers in one transaction
+  * @note   Requires register auto-increment (CTRL3_C.if_inc, set by begin())
+  * @param  Reg address of the first register
+  * @param  Data pointer where the values are written
+  * @param  Len number of registers
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_Reg(uint8_t Reg, uint8_t *Data, uint16_t Len)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_READ_REG);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (readRegister(Reg, Data, Len) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Read several bursts of consecutive registers
+  * @note   A bus that chains the bursts (LSM6DSO16IS_Linux_I2C,
+  *         LSM6DSO16IS_Linux_SPI) reads them all in one transfer, e.g. status,
+  *         outputs and timestamp of a sample in a single system call
+  * @param  Groups the bursts to read, in the current register bank
+  * @param  Count number of bursts
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_Reg_Groups(const LSM6DSO16IS_Read_Group_t *Groups, uint8_t Count)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_READ_REG);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  Lock();
+  if (bank_fault_recover() != 0) {
+    Unlock();
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+#ifdef LSM6DSO16IS_BUS_TIMING
+  uint32_t bytes = 0;
+
+  for (uint8_t i = 0; i < Count; i++) {
+    bytes += Groups[i].len;
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    drdy_read_start(Groups[i].reg);
+#endif
+  }
+  uint32_t start = lsm6dso16is_cycles();
+#endif
+  if (bus != NULL) {
+    if (bus->read_groups(Groups, Count) != 0) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  } else {
+    for (uint8_t i = 0; (i < Count) && (ret == LSM6DSO16IS_STATUS_OK); i++) {
+      if (readBus(Groups[i].reg, Groups[i].data, Groups[i].len) != LSM6DSO16IS_STATUS_OK) {
+        ret = LSM6DSO16IS_STATUS_ERROR;
+      }
+    }
+  }
+#ifdef LSM6DSO16IS_BUS_TIMING
+  bus_account(Count, bytes, start);
+#endif
+  Unlock();
+
+  return ret;
+}
+
 
 /**
  * @brief  Get the status of all ISPU events
@@ -807,6 +1468,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_Reg(uint8_t Reg, uint8_t *Data)
  */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Status(LSM6DSO16IS_ISPU_Status_t *Status)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_GET_ISPU_STATUS);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
 
   union {
@@ -831,6 +1493,7 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Status(LSM6DSO16IS_ISPU_Status_t
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_ISPU_Output(uint8_t Reg, uint8_t *Data, uint8_t len)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_READ_ISPU_OUTPUT);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   //Check that register to read is an ISPU Output register
   if (Reg < LSM6DSO16IS_ISPU_DOUT_00_L || Reg > LSM6DSO16IS_ISPU_DOUT_31_H) {
@@ -858,15 +1521,72 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Read_ISPU_Output(uint8_t Reg, uint8_t *Dat
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Write_Reg(uint8_t Reg, uint8_t Data)
 {
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_WRITE_REG);
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
-/*
-  if (lsm6dso16is_write_reg(&reg_ctx, Reg, &Data, 1) != LSM6DSO16IS_STATUS_OK) {
+
+  if (writeRegister(Reg, &Data, 1) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
+  return ret;
+}
+
+/**
+  * @brief  Set consecutive LSM6DSO16IS registers in one transaction
+  * @note   Requires register auto-increment (CTRL3_C.if_inc, set by begin())
+  * @param  Reg address of the first register
+  * @param  Data values to be written
+  * @param  Len number of registers, at most LSM6DSO16IS_MAX_WRITE_LEN
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Write_Reg(uint8_t Reg, const uint8_t *Data, uint16_t Len)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_WRITE_REG);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if ((Len == 0U) || (Len > LSM6DSO16IS_MAX_WRITE_LEN)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (writeRegister(Reg, Data, Len) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
   return ret;
 }
 
+/**
+  * @brief  Execute a list of register writes in the fewest transactions
+  * @note   Runs of entries on consecutive addresses are merged into one burst
+  *         (up to LSM6DSO16IS_MAX_WRITE_LEN bytes); the order of the list is
+  *         kept, so writes that depend on each other stay in sequence. Requires
+  *         register auto-increment (CTRL3_C.if_inc, set by begin()).
+  * @param  List the (register, value) pairs
+  * @param  Count number of entries in List
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Write_Reg_List(const LSM6DSO16IS_Reg_Write_t *List, uint16_t Count)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_WRITE_REG);
+  uint8_t buff[LSM6DSO16IS_MAX_WRITE_LEN];
+  uint16_t i = 0;
+
+  while (i < Count) {
+    uint8_t reg = List[i].reg;
+    uint16_t len = 0;
+
+    while ((i < Count) && (len < LSM6DSO16IS_MAX_WRITE_LEN) && (List[i].reg == (uint8_t)(reg + len))) {
+      buff[len++] = List[i++].value;
+    }
+
+    if (writeRegister(reg, buff, len) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
 /**
   * @brief  Set self test
   * @param  Val the value of st_xl in reg CTRL5_C
@@ -880,15 +1600,30 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_SelfTest(uint8_t Val)
   reg = (Val == 1U)  ? LSM6DSO16IS_XL_ST_POSITIVE
         : (Val == 2U)  ? LSM6DSO16IS_XL_ST_NEGATIVE
         :                LSM6DSO16IS_XL_ST_DISABLE;
-/*
-  if (lsm6dso16is_xl_self_test_set(&reg_ctx, reg) != LSM6DSO16IS_STATUS_OK) {
+
+  if (xl_self_test_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
 
+/**
+  * @brief  Run the LSM6DSO16IS accelerometer self-test
+  * @note   Datasheet procedure at 52 Hz, +/-4 g: after settling, the average of
+  *         Samples outputs without stimulus is compared with the averages with
+  *         positive and negative stimulus. Samples are summed as raw integers and
+  *         scaled once at the end. CTRL1_XL..CTRL7_G are restored afterwards.
+  * @param  Samples number of samples averaged in each phase, 5 in the datasheet
+  * @param  Report per-axis deltas in mg and pass/fail against LSM6DSO16IS_XL_ST_MIN/MAX_MG
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Run_X_SelfTest(uint8_t Samples, LSM6DSO16IS_SelfTest_Report_t *Report)
+{
+  return self_test_run(1, Samples, Report);
+}
+
 /**
   * @brief  Get the LSM6DSO16IS ACC data ready bit value
   * @param  Status the status of data ready bit
@@ -897,11 +1632,14 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_SelfTest(uint8_t Val)
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_X_DRDY_Status(uint8_t *Status)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
-/*
-  if (lsm6dso16is_xl_flag_data_ready_get(&reg_ctx, Status) != LSM6DSO16IS_STATUS_OK) {
+  lsm6dso16is_status_reg_t status;
+
+  if (status_reg_get(&status) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    *Status = status.xlda;
   }
-*/
+
   return ret;
 }
 
@@ -928,22 +1666,21 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_INT1_DRDY(uint8_t Val)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_pin_int1_route_t reg;
-/*
-  if (lsm6dso16is_pin_int1_route_get(&reg_ctx, &reg) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+
+  if (pin_int1_route_get(&reg) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   if (Val <= 1U) {
     reg.drdy_xl = Val;
   } else {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+    return LSM6DSO16IS_STATUS_ERROR;
   }
 
-/*
-  if (lsm6dso16is_pin_int1_route_set(&reg_ctx, reg) != LSM6DSO16IS_STATUS_OK) {
+  if (pin_int1_route_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
@@ -961,14 +1698,25 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_SelfTest(uint8_t Val)
         : (Val == 2U)  ? LSM6DSO16IS_GY_ST_NEGATIVE
         :                LSM6DSO16IS_GY_ST_DISABLE;
 
-/*
-  if (lsm6dso16is_gy_self_test_set(&reg_ctx, reg) != LSM6DSO16IS_STATUS_OK) {
+  if (gy_self_test_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
+/**
+  * @brief  Run the LSM6DSO16IS gyroscope self-test
+  * @note   Datasheet procedure at 208 Hz, +/-2000 dps, see Run_X_SelfTest()
+  * @param  Samples number of samples averaged in each phase, 5 in the datasheet
+  * @param  Report per-axis deltas in mdps and pass/fail against LSM6DSO16IS_G_ST_MIN/MAX_MDPS
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Run_G_SelfTest(uint8_t Samples, LSM6DSO16IS_SelfTest_Report_t *Report)
+{
+  return self_test_run(0, Samples, Report);
+}
+
 /**
   * @brief  Get the LSM6DSO16IS GYRO data ready bit value
   * @param  Status the status of data ready bit
@@ -977,11 +1725,14 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_SelfTest(uint8_t Val)
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_DRDY_Status(uint8_t *Status)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
-/*
-  if (lsm6dso16is_gy_flag_data_ready_get(&reg_ctx, Status) != LSM6DSO16IS_STATUS_OK) {
+  lsm6dso16is_status_reg_t status;
+
+  if (status_reg_get(&status) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    *Status = status.gda;
   }
-*/
+
   return ret;
 }
 
@@ -1008,28 +1759,27 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_INT1_DRDY(uint8_t Val)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
   lsm6dso16is_pin_int1_route_t reg;
-/*
-  if (lsm6dso16is_pin_int1_route_get(&reg_ctx, &reg) != LSM6DSO16IS_STATUS_OK) {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+
+  if (pin_int1_route_get(&reg) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   if (Val <= 1U) {
     reg.drdy_gy = Val;
   } else {
-    ret = LSM6DSO16IS_STATUS_ERROR;
+    return LSM6DSO16IS_STATUS_ERROR;
   }
-/*
-  if (lsm6dso16is_pin_int1_route_set(&reg_ctx, reg) != LSM6DSO16IS_STATUS_OK) {
+  if (pin_int1_route_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
 
 /**
   * @brief  Set DRDY mode
-  * @param  Val the value of drdy_pulsed in reg LSM6DSO16IS_DRDY_PULSE_CFG_G
+  * @param  Val the value of drdy_pulsed in reg LSM6DSO16IS_DRDY_PULSED_REG
   * @retval 0 in case of success, an error code otherwise
   */
 LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_DRDY_Mode(uint8_t Val)
@@ -1039,669 +1789,2333 @@ LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_DRDY_Mode(uint8_t Val)
 
   reg = (Val == 0U)  ? LSM6DSO16IS_DRDY_LATCHED
         :                LSM6DSO16IS_DRDY_PULSED;
-/*
-  if (lsm6dso16is_data_ready_mode_set(&reg_ctx, reg) != LSM6DSO16IS_STATUS_OK) {
+
+  if (data_ready_mode_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
 /**
-  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate when enabled
-  * @param  Odr the functional output data rate to be set
+  * @brief  Set DRDY on INT2
+  * @param  Val the value of int2_drdy_xl in reg INT2_CTRL
   * @retval 0 in case of success, an error code otherwise
   */
-LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR_When_Enabled(float_t Odr)
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_INT2_DRDY(uint8_t Val)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
-  lsm6dso16is_xl_data_rate_t new_odr;
+  lsm6dso16is_pin_int2_route_t reg;
 
-  new_odr = (Odr <=   12.5f) ? LSM6DSO16IS_XL_ODR_AT_12Hz5_HP
-            : (Odr <=   26.0f) ? LSM6DSO16IS_XL_ODR_AT_26H_HP
-            : (Odr <=   52.0f) ? LSM6DSO16IS_XL_ODR_AT_52Hz_HP
-            : (Odr <=  104.0f) ? LSM6DSO16IS_XL_ODR_AT_104Hz_HP
-            : (Odr <=  208.0f) ? LSM6DSO16IS_XL_ODR_AT_208Hz_HP
-            : (Odr <=  416.0f) ? LSM6DSO16IS_XL_ODR_AT_416Hz_HP
-            : (Odr <=  833.0f) ? LSM6DSO16IS_XL_ODR_AT_833Hz_HP
-            : (Odr <= 1667.0f) ? LSM6DSO16IS_XL_ODR_AT_1667Hz_HP
-            : (Odr <= 3333.0f) ? LSM6DSO16IS_XL_ODR_AT_3333Hz_HP
-            :                    LSM6DSO16IS_XL_ODR_AT_6667Hz_HP;
+  if (pin_int2_route_get(&reg) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-  /* Output data rate selection. */
-  /*
-  if (lsm6dso16is_xl_data_rate_set(&reg_ctx, new_odr) != LSM6DSO16IS_STATUS_OK) {
+  if (Val <= 1U) {
+    reg.drdy_xl = Val;
+  } else {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (pin_int2_route_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
 /**
-  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate when disabled
-  * @param  Odr the functional output data rate to be set
+  * @brief  Set DRDY on INT2
+  * @param  Val the value of int2_drdy_g in reg INT2_CTRL
   * @retval 0 in case of success, an error code otherwise
   */
-LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR_When_Disabled(float_t Odr)
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_INT2_DRDY(uint8_t Val)
 {
-  X_Last_ODR = (Odr <=   12.5f) ? LSM6DSO16IS_XL_ODR_AT_12Hz5_HP
-               : (Odr <=   26.0f) ? LSM6DSO16IS_XL_ODR_AT_26H_HP
-               : (Odr <=   52.0f) ? LSM6DSO16IS_XL_ODR_AT_52Hz_HP
-               : (Odr <=  104.0f) ? LSM6DSO16IS_XL_ODR_AT_104Hz_HP
-               : (Odr <=  208.0f) ? LSM6DSO16IS_XL_ODR_AT_208Hz_HP
-               : (Odr <=  416.0f) ? LSM6DSO16IS_XL_ODR_AT_416Hz_HP
-               : (Odr <=  833.0f) ? LSM6DSO16IS_XL_ODR_AT_833Hz_HP
-               : (Odr <= 1667.0f) ? LSM6DSO16IS_XL_ODR_AT_1667Hz_HP
-               : (Odr <= 3333.0f) ? LSM6DSO16IS_XL_ODR_AT_3333Hz_HP
-               :                    LSM6DSO16IS_XL_ODR_AT_6667Hz_HP;
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_pin_int2_route_t reg;
 
-  return LSM6DSO16IS_STATUS_OK;
+  if (pin_int2_route_get(&reg) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (Val <= 1U) {
+    reg.drdy_gy = Val;
+  } else {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (pin_int2_route_set(reg) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
 }
 
 /**
-  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate when enabled
-  * @param  Odr the functional output data rate to be set
+  * @brief  Set temperature DRDY on INT2
+  * @param  Val the value of int2_drdy_temp in reg INT2_CTRL
   * @retval 0 in case of success, an error code otherwise
   */
-LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR_When_Enabled(float_t Odr)
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_T_INT2_DRDY(uint8_t Val)
 {
   LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
-  lsm6dso16is_gy_data_rate_t new_odr;
+  lsm6dso16is_pin_int2_route_t reg;
 
-  new_odr = (Odr <=   12.5f) ? LSM6DSO16IS_GY_ODR_AT_12Hz5_HP
-            : (Odr <=   26.0f) ? LSM6DSO16IS_GY_ODR_AT_26H_HP
-            : (Odr <=   52.0f) ? LSM6DSO16IS_GY_ODR_AT_52Hz_HP
-            : (Odr <=  104.0f) ? LSM6DSO16IS_GY_ODR_AT_104Hz_HP
-            : (Odr <=  208.0f) ? LSM6DSO16IS_GY_ODR_AT_208Hz_HP
-            : (Odr <=  416.0f) ? LSM6DSO16IS_GY_ODR_AT_416Hz_HP
-            : (Odr <=  833.0f) ? LSM6DSO16IS_GY_ODR_AT_833Hz_HP
-            : (Odr <= 1667.0f) ? LSM6DSO16IS_GY_ODR_AT_1667Hz_HP
-            : (Odr <= 3333.0f) ? LSM6DSO16IS_GY_ODR_AT_3333Hz_HP
-            :                    LSM6DSO16IS_GY_ODR_AT_6667Hz_HP;
+  if (pin_int2_route_get(&reg) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-  /* Output data rate selection. */
-  /*
-  if (lsm6dso16is_gy_data_rate_set(&reg_ctx, new_odr) != LSM6DSO16IS_STATUS_OK) {
+  if (Val <= 1U) {
+    reg.drdy_temp = Val;
+  } else {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (pin_int2_route_set(reg) != LSM6DSO16IS_STATUS_OK) {
     ret = LSM6DSO16IS_STATUS_ERROR;
   }
-*/
+
   return ret;
 }
 
 /**
-  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate when disabled
-  * @param  Odr the functional output data rate to be set
+  * @brief  Route all the INT2 signals on INT1 as well
+  * @note   For boards with a single interrupt line: the INT1 handler then has
+  *         to read STATUS_REG to know which sensor fired
+  * @param  Val the value of int2_on_int1 in reg CTRL4_C
   * @retval 0 in case of success, an error code otherwise
   */
-LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR_When_Disabled(float_t Odr)
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_INT2_On_INT1(uint8_t Val)
 {
-  G_Last_ODR = (Odr <=   12.5f) ? LSM6DSO16IS_GY_ODR_AT_12Hz5_HP
-               : (Odr <=   26.0f) ? LSM6DSO16IS_GY_ODR_AT_26H_HP
-               : (Odr <=   52.0f) ? LSM6DSO16IS_GY_ODR_AT_52Hz_HP
-               : (Odr <=  104.0f) ? LSM6DSO16IS_GY_ODR_AT_104Hz_HP
-               : (Odr <=  208.0f) ? LSM6DSO16IS_GY_ODR_AT_208Hz_HP
-               : (Odr <=  416.0f) ? LSM6DSO16IS_GY_ODR_AT_416Hz_HP
-               : (Odr <=  833.0f) ? LSM6DSO16IS_GY_ODR_AT_833Hz_HP
-               : (Odr <= 1667.0f) ? LSM6DSO16IS_GY_ODR_AT_1667Hz_HP
-               : (Odr <= 3333.0f) ? LSM6DSO16IS_GY_ODR_AT_3333Hz_HP
-               :                    LSM6DSO16IS_GY_ODR_AT_6667Hz_HP;
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
 
-  return LSM6DSO16IS_STATUS_OK;
-}
+  if (Val > 1U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-/* Utility */
+  if (int2_on_int1_set(Val) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate when enabled
+  * @param  Odr the functional output data rate to be set
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR_When_Enabled(float_t Odr)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_xl_data_rate_t new_odr;
+
+  new_odr = lsm6dso16is_xl_odr_code(Odr, X_Last_Mode);
+
+  /* Output data rate selection. */
+  if (xl_data_rate_set(new_odr) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate when disabled
+  * @param  Odr the functional output data rate to be set
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR_When_Disabled(float_t Odr)
+{
+  X_Last_ODR = lsm6dso16is_xl_odr_hz((uint8_t)lsm6dso16is_xl_odr_code(Odr, X_Last_Mode));
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate when enabled
+  * @param  Odr the functional output data rate to be set
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR_When_Enabled(float_t Odr)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_gy_data_rate_t new_odr;
+
+  new_odr = lsm6dso16is_gy_odr_code(Odr, G_Last_Mode);
+
+  /* Output data rate selection. */
+  if (gy_data_rate_set(new_odr) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate when disabled
+  * @param  Odr the functional output data rate to be set
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR_When_Disabled(float_t Odr)
+{
+  G_Last_ODR = lsm6dso16is_gy_odr_hz((uint8_t)lsm6dso16is_gy_odr_code(Odr, G_Last_Mode));
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS accelerometer sensor output data rate and power mode
+  * @param  Odr the functional output data rate to be set
+  * @param  Mode high performance or low power mode
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_X_ODR_With_Mode(float_t Odr, LSM6DSO16IS_Operating_Mode_t Mode)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_X_ODR);
+  X_Last_Mode = Mode;
+
+  return Set_X_ODR(Odr);
+}
+
+/**
+  * @brief  Set the LSM6DSO16IS gyroscope sensor output data rate and power mode
+  * @param  Odr the functional output data rate to be set
+  * @param  Mode high performance or low power mode
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_ODR_With_Mode(float_t Odr, LSM6DSO16IS_Operating_Mode_t Mode)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_SET_G_ODR);
+  G_Last_Mode = Mode;
+
+  return Set_G_ODR(Odr);
+}
+
+/**
+  * @brief  Put the LSM6DSO16IS gyroscope in sleep mode
+  * @note   The gyroscope stays clocked but stops producing output, so it wakes up
+  *         much faster than from power-down (Disable_G)
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Sleep_G(void)
+{
+  if (G_isEnabled == 0U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (gy_sleep_mode_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  G_Standby = LSM6DSO16IS_G_SLEEP;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Put the LSM6DSO16IS gyroscope in the cheapest standby for the expected idle time
+  * @note   Short idle periods use sleep mode, whose fast wake-up is worth its
+  *         higher current; longer ones (above Set_G_Sleep_Max_Idle()) power the
+  *         gyroscope down. Wake_G() resumes from either state.
+  * @param  Expected_Idle_ms expected time before the gyroscope is needed again
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Standby_G(uint32_t Expected_Idle_ms)
+{
+  if (G_Standby != LSM6DSO16IS_G_ACTIVE) {
+    return LSM6DSO16IS_STATUS_OK;
+  }
+
+  if (Expected_Idle_ms <= G_Sleep_Max_Idle_ms) {
+    return Sleep_G();
+  }
+
+  if (G_isEnabled == 0U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (Disable_G() != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  G_Standby = LSM6DSO16IS_G_POWER_DOWN;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Wake up the LSM6DSO16IS gyroscope from sleep mode or power-down
+  * @note   Waits for the first new sample (STATUS_REG.gda) and records the time
+  *         taken, see Get_G_Wake_Latency()
+  * @param  Timeout_us maximum time to wait for the first sample,
+  *         LSM6DSO16IS_G_WAKE_TIMEOUT_US by default
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Wake_G(uint32_t Timeout_us)
+{
+  lsm6dso16is_status_reg_t status;
+  int16_t stale[3];
+  uint32_t start_us;
+  uint32_t elapsed_us;
+
+  if (G_Standby == LSM6DSO16IS_G_ACTIVE) {
+    return LSM6DSO16IS_STATUS_OK;
+  }
+
+  /* Drop a sample left over from before the standby, so that gda reports a new one. */
+  if (status_reg_get(&status) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if ((status.gda == 1U) && (angular_rate_raw_get(stale) != LSM6DSO16IS_STATUS_OK)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  start_us = lsm6dso16is_time_us();
+  if (G_Standby == LSM6DSO16IS_G_SLEEP) {
+    if (gy_sleep_mode_set(PROPERTY_DISABLE) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+  } else {
+    if (Enable_G() != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+  G_Standby = LSM6DSO16IS_G_ACTIVE;
+
+  for (;;) {
+    if (status_reg_get(&status) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+    elapsed_us = lsm6dso16is_time_us() - start_us;
+    if (status.gda == 1U) {
+      break;
+    }
+    if (elapsed_us >= Timeout_us) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    lsm6dso16is_delay_us(LSM6DSO16IS_G_WAKE_POLL_US);
+  }
+
+  G_Wake_Latency_us = elapsed_us;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the LSM6DSO16IS gyroscope standby state
+  * @param  State active, sleep mode or power-down
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Standby(LSM6DSO16IS_G_Standby_t *State)
+{
+  *State = G_Standby;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the duration of the last gyroscope wake-up
+  * @param  Latency_us time from Wake_G() to the first new sample, in microseconds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_G_Wake_Latency(uint32_t *Latency_us)
+{
+  *Latency_us = G_Wake_Latency_us;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Set the longest expected idle time for which Standby_G() uses sleep mode
+  * @param  Idle_ms the threshold in milliseconds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_G_Sleep_Max_Idle(uint32_t Idle_ms)
+{
+  G_Sleep_Max_Idle_ms = Idle_ms;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Hold the ISPU core in reset
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Reset_ISPU(void)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_ispu_config_t ispu_config;
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (readRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    ispu_config.ispu_rst_n = PROPERTY_DISABLE;
+    if (writeRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  ispu_boot_pending = 0;
+  return ret;
+}
+
+/**
+  * @brief  Gate or ungate the ISPU clock
+  * @param  Val 1 to run the ISPU clock, 0 to gate it and save power
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_ISPU_Clock(uint8_t Val)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_ispu_config_t ispu_config;
+
+  if (Val > 1U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (readRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    ispu_config.clk_dis = (Val == 1U) ? 0x0U : 0x1U;
+    if (writeRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Set ISPU interrupt mode
+  * @param  Val the value of latched in reg ISPU_CONFIG (0 pulsed, 1 latched)
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_ISPU_Int_Latched(uint8_t Val)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_ispu_config_t ispu_config;
+
+  if (Val > 1U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (readRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    ispu_config.latched = Val;
+    if (writeRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Ungate the ISPU clock and release the core from reset
+  * @note   The boot time measurement starts here and ends in Wait_ISPU_Boot()
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Start_ISPU(void)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  lsm6dso16is_ispu_config_t ispu_config;
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+  /* Route the boot event on INT1 before the core starts, so it cannot be missed.
+     Not while a DMA capture owns INT1: its edges only start transfers. */
+  ispu_boot_irq = 0;
+  if ((int1_pin != NULL) && !dma_on_int1()) {
+    ispu_boot_flags.clear(LSM6DSO16IS_ISPU_BOOT_FLAG);
+    ispu_boot_irq = 1;
+    if (int1_boot_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+#endif
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (readRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  } else {
+    ispu_config.clk_dis = PROPERTY_DISABLE;
+    ispu_config.ispu_rst_n = PROPERTY_ENABLE;
+    ispu_boot_start_us = lsm6dso16is_time_us();
+    if (writeRegister(LSM6DSO16IS_ISPU_CONFIG, (uint8_t *)&ispu_config, 1) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (ret == LSM6DSO16IS_STATUS_OK) {
+    ispu_boot_pending = 1;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Wait for the end of the ISPU boot started by Start_ISPU()
+  * @note   If an INT1 pin has been set with Set_INT1_Pin() the calling thread
+  *         sleeps until the boot event, otherwise ISPU_STATUS is polled with an
+  *         exponential backoff instead of spinning on the bus
+  * @param  Timeout_ms maximum time to wait in milliseconds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Wait_ISPU_Boot(uint32_t Timeout_ms)
+{
+  uint8_t boot_end = 0;
+  uint32_t elapsed_us;
+  uint32_t backoff_us = LSM6DSO16IS_ISPU_BOOT_BACKOFF_MIN_US;
+
+  if (ispu_boot_pending == 0U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+  if (ispu_boot_irq != 0U) {
+    ispu_boot_flags.wait_any_for(LSM6DSO16IS_ISPU_BOOT_FLAG, std::chrono::milliseconds(Timeout_ms));
+    (void)int1_boot_set(PROPERTY_DISABLE);
+  }
+#endif
+
+  /* Confirm on ISPU_STATUS: this is also the fallback when INT1 is not wired. */
+  for (;;) {
+    if (ispu_boot_end_get(&boot_end) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+    elapsed_us = lsm6dso16is_time_us() - ispu_boot_start_us;
+    if (boot_end == 1U) {
+      break;
+    }
+    /* Compared in ms: Timeout_ms * 1000 would overflow above ~71 minutes. */
+    if ((elapsed_us / 1000U) >= Timeout_ms) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    backoff_wait(&backoff_us, LSM6DSO16IS_ISPU_BOOT_BACKOFF_MAX_US);
+  }
+
+  ispu_boot_time_us = elapsed_us;
+  ispu_boot_pending = 0;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the ISPU boot status
+  * @param  Status the value of boot_end in reg ISPU_STATUS
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Boot_Status(uint8_t *Status)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (ispu_boot_end_get(Status) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Get the duration of the last completed ISPU boot
+  * @param  Time_us time from Start_ISPU() to boot end, in microseconds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Boot_Time(uint32_t *Time_us)
+{
+  *Time_us = ispu_boot_time_us;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Enable or disable the timestamp counter
+  * @param  Val the value of timestamp_en in reg CTRL10_C
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_Timestamp(uint8_t Val)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (Val > 1U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (timestamp_set(Val) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Get the device timestamp
+  * @note   One LSB is LSM6DSO16IS_TIMESTAMP_LSB_NS; the counter wraps at 32 bits
+  * @param  Ticks the value of TIMESTAMP0..TIMESTAMP3
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_Timestamp(uint32_t *Ticks)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (timestamp_raw_get(Ticks) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+/**
+  * @brief  Set the MCU pin connected to the sensor INT1 line
+  * @param  Int1 the pin name, NC to detach
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_INT1_Pin(PinName Int1)
+{
+  delete int1_pin;
+  int1_pin = NULL;
+
+  if (Int1 != NC) {
+    int1_pin = new InterruptIn(Int1);
+    int1_pin->rise(callback(this, &LSM6DSO16IS::int1_isr));
+  }
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Set the MCU pin connected to the sensor INT2 line
+  * @param  Int2 the pin name, NC to detach
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Set_INT2_Pin(PinName Int2)
+{
+  delete int2_pin;
+  int2_pin = NULL;
+
+  if (Int2 != NC) {
+    int2_pin = new InterruptIn(Int2);
+    int2_pin->rise(callback(this, &LSM6DSO16IS::int2_isr));
+  }
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Capture the data-ready events signalled on INT1
+  * @param  Queue event queue where Handler is posted, NULL to stop capturing
+  * @param  Handler function called with the timestamp of the edge in us
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_DRDY_Capture(EventQueue *Queue, Callback<void(uint32_t)> Handler)
+{
+  return Enable_DRDY_Capture(LSM6DSO16IS_INT1_PIN, Queue, Handler);
+}
+
+/**
+  * @brief  Capture the data-ready events signalled on an interrupt pin
+  * @note   The pin must have been set with Set_INT1_Pin() / Set_INT2_Pin() and
+  *         the data-ready signals routed with Set_X_INT1_DRDY(), Set_G_INT2_DRDY(), ...
+  *         The interrupt handler only takes a timestamp and posts Handler to
+  *         Queue: the bus access runs in the thread that dispatches Queue.
+  *         Routing one sensor per pin lets each handler read only the output
+  *         registers of its sensor, without going through STATUS_REG. Pulsed
+  *         data-ready (Set_DRDY_Mode(1)) is recommended, so that every sample
+  *         produces an edge even if the previous one has not been read yet.
+  * @param  Pin the interrupt pin
+  * @param  Queue event queue where Handler is posted, NULL to stop capturing
+  * @param  Handler function called with the timestamp of the edge in us
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Enable_DRDY_Capture(LSM6DSO16IS_SensorIntPin_t Pin, EventQueue *Queue,
+                                                          Callback<void(uint32_t)> Handler)
+{
+  InterruptIn *int_pin = int_pin_get(Pin);
+
+  if ((Queue != NULL) && (int_pin == NULL)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (int_pin != NULL) {
+    int_pin->disable_irq();
+  }
+  drdy_handler[Pin] = Handler;
+  drdy_queue[Pin] = Queue;
+  drdy_captured[Pin] = 0;
+  drdy_dropped[Pin] = 0;
+  if (int_pin != NULL) {
+    int_pin->enable_irq();
+  }
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the data-ready capture counters of INT1
+  * @param  Captured number of events posted to the queue
+  * @param  Dropped number of events lost because the queue was full
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_DRDY_Capture_Stats(uint32_t *Captured, uint32_t *Dropped)
+{
+  return Get_DRDY_Capture_Stats(LSM6DSO16IS_INT1_PIN, Captured, Dropped);
+}
+
+/**
+  * @brief  Get the data-ready capture counters of an interrupt pin
+  * @param  Pin the interrupt pin
+  * @param  Captured number of events posted to the queue
+  * @param  Dropped number of events lost because the queue was full
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_DRDY_Capture_Stats(LSM6DSO16IS_SensorIntPin_t Pin, uint32_t *Captured,
+                                                             uint32_t *Dropped)
+{
+  *Captured = drdy_captured[Pin];
+  *Dropped = drdy_dropped[Pin];
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+#if DEVICE_SPI_ASYNCH
+/**
+  * @brief  Capture the outputs with SPI DMA transfers into two alternating buffers
+  * @note   Each data-ready edge on Pin starts one asynchronous 13-byte transfer
+  *         (command byte, then OUTX_L_G .. OUTZ_H_A, the block read by
+  *         angular_rate_raw_get() and acceleration_raw_get()); the CPU only
+  *         runs the edge and completion interrupts. When Samples transfers
+  *         have filled a buffer, Handler is posted to Queue with that buffer
+  *         while the other one is filled. A buffer is handed back when Handler
+  *         returns: if both are still in use the new block is dropped and
+  *         counted as an overrun. Decode the samples with Get_DMA_Sample().
+  *         Blocking register accesses are still allowed: they wait for the
+  *         transfer in flight and hold off the data-ready interrupt meanwhile.
+  *         Requires the SPI constructor and the pin set with Set_INT1_Pin() or
+  *         Set_INT2_Pin(); use the pulsed data-ready mode at high ODR.
+  *         INT1 cannot be used while an ISPU boot signalled on INT1 is
+  *         pending; an ISPU started during an INT1 capture is waited for by
+  *         polling ISPU_STATUS. A transfer that does not complete within
+  *         LSM6DSO16IS_DMA_PAUSE_TIMEOUT_US when a blocking access needs the
+  *         bus is aborted, and that access fails.
+  * @param  Pin the interrupt pin carrying the data-ready signal
+  * @param  Buf0 first buffer, LSM6DSO16IS_DMA_BUF_SIZE(Samples) bytes
+  * @param  Buf1 second buffer, LSM6DSO16IS_DMA_BUF_SIZE(Samples) bytes
+  * @param  Samples number of samples per buffer
+  * @param  Queue event queue where Handler is posted
+  * @param  Handler function called with a full buffer and its number of samples
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Start_DMA_Capture(LSM6DSO16IS_SensorIntPin_t Pin, uint8_t *Buf0, uint8_t *Buf1,
+                                                        uint16_t Samples, EventQueue *Queue,
+                                                        Callback<void(const uint8_t *, uint16_t)> Handler)
+{
+  InterruptIn *int_pin = int_pin_get(Pin);
+
+  if ((spi == NULL) || (int_pin == NULL) || (Buf0 == NULL) || (Buf1 == NULL) || (Samples == 0U) ||
+      (Queue == NULL)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  /* Il fronte di fine boot ISPU su INT1 verrebbe preso per un data-ready */
+  if ((Pin == LSM6DSO16IS_INT1_PIN) && (ispu_boot_pending != 0U) && (ispu_boot_irq != 0U)) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (Stop_DMA_Capture() != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  dma_tx[0] = LSM6DSO16IS_OUTX_L_G | LSM6DSO16IS_SPI_READ;
+  for (uint8_t i = 1; i < LSM6DSO16IS_DMA_SAMPLE_SIZE; i++) {
+    dma_tx[i] = 0;
+  }
+
+  int_pin->disable_irq();
+  dma_buf[0] = Buf0;
+  dma_buf[1] = Buf1;
+  dma_samples = Samples;
+  dma_index = 0;
+  dma_fill = 0;
+  dma_pending[0] = 0;
+  dma_pending[1] = 0;
+  dma_pin = Pin;
+  dma_queue = Queue;
+  dma_handler = Handler;
+  dma_blocks = 0;
+  dma_overruns = 0;
+  spi->set_dma_usage(DMA_USAGE_ALWAYS);
+  dma_active = 1;
+  int_pin->enable_irq();
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Stop the DMA capture
+  * @note   Waits for the transfer in flight; a partially filled buffer is
+  *         discarded. The capture is stopped also when the transfer in flight
+  *         had to be aborted, but an error is returned
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Stop_DMA_Capture(void)
+{
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  InterruptIn *int_pin;
+
+  if (dma_pause(&int_pin) != 0) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+  dma_active = 0;
+  dma_resume(int_pin);
+
+  return ret;
+}
+
+/**
+  * @brief  Get the DMA capture counters
+  * @param  Blocks number of full buffers posted to the queue
+  * @param  Overruns number of samples or blocks lost
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_DMA_Capture_Stats(uint32_t *Blocks, uint32_t *Overruns)
+{
+  *Blocks = dma_blocks;
+  *Overruns = dma_overruns;
+
+  return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Decode one sample of a DMA capture buffer
+  * @param  Block the buffer passed to the capture handler
+  * @param  Index index of the sample in the buffer
+  * @param  Gyro pointer where the raw angular rate is written, may be NULL
+  * @param  Accel pointer where the raw acceleration is written, may be NULL
+  */
+void LSM6DSO16IS::Get_DMA_Sample(const uint8_t *Block, uint16_t Index, int16_t *Gyro, int16_t *Accel)
+{
+  const uint8_t *buff = Block + ((uint32_t)Index * LSM6DSO16IS_DMA_SAMPLE_SIZE) + 1U;
+
+  for (uint8_t i = 0; i < 3U; i++) {
+    if (Gyro != NULL) {
+      Gyro[i] = (int16_t)((uint16_t)buff[2U * i] | ((uint16_t)buff[(2U * i) + 1U] << 8));
+    }
+    if (Accel != NULL) {
+      Accel[i] = (int16_t)((uint16_t)buff[6U + (2U * i)] | ((uint16_t)buff[7U + (2U * i)] << 8));
+    }
+  }
+}
+#endif
+#endif
+
+/**
+  * @brief  Write parameter words to the ISPU mailbox and raise IF2S flags
+  * @note   The words are written to ISPU_DUMMY_CFG_1..4 in one burst, then the
+  *         flags are raised with a single access to the ISPU bank
+  * @param  Words parameter words, Words[0] goes to ISPU_DUMMY_CFG_1
+  * @param  Count number of words to write (0 to 4)
+  * @param  If2s_Flags bits to set in ISPU_IF2S_FLAG_H:L
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Write_ISPU_Mailbox(const uint16_t *Words, uint8_t Count, uint16_t If2s_Flags)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_MAILBOX);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (mailbox_words_write(Words, Count) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (If2s_Flags != 0U) {
+    if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+    if (mailbox_if2s_write(If2s_Flags) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+    if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Read the ISPU mailbox flags
+  * @note   IF2S and S2IF are contiguous and are read in one burst
+  * @param  If2s_Flags IF2S bits still pending (not yet cleared by the ISPU)
+  * @param  S2if_Flags S2IF bits raised by the ISPU
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Mailbox_Flags(uint16_t *If2s_Flags, uint16_t *S2if_Flags)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_MAILBOX);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (mailbox_flags_get(If2s_Flags, S2if_Flags) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Post a mailbox message to the ISPU and wait for its acknowledgement
+  * @note   IF2S is raised and the flags are then polled with a short backoff
+  *         until the ISPU clears the posted IF2S bits or raises one of the
+  *         S2IF bits in Ack_Mask. The main bank is selected again, and the
+  *         bus lock released, during each backoff
+  * @param  Words parameter words, Words[0] goes to ISPU_DUMMY_CFG_1
+  * @param  Count number of words to write (0 to 4)
+  * @param  If2s_Flags bits to set in ISPU_IF2S_FLAG_H:L, must not be 0
+  * @param  Ack_Mask S2IF bits accepted as acknowledgement, 0 to wait for IF2S only
+  * @param  Timeout_us maximum time to wait in microseconds
+  * @param  S2if_Flags pointer where the last S2IF value is written, may be NULL
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Send_ISPU_Mailbox(const uint16_t *Words, uint8_t Count, uint16_t If2s_Flags,
+                                                       uint16_t Ack_Mask, uint32_t Timeout_us, uint16_t *S2if_Flags)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_MAILBOX);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_ERROR;
+  uint16_t if2s = 0;
+  uint16_t s2if = 0;
+  uint32_t start_us;
+  uint32_t backoff_us = LSM6DSO16IS_ISPU_MAILBOX_BACKOFF_MIN_US;
+
+  if (If2s_Flags == 0U) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mailbox_words_write(Words, Count) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mailbox_if2s_write(If2s_Flags) == LSM6DSO16IS_STATUS_OK) {
+    start_us = lsm6dso16is_time_us();
+    for (;;) {
+      if (mailbox_flags_get(&if2s, &s2if) != LSM6DSO16IS_STATUS_OK) {
+        break;
+      }
+      if (((if2s & If2s_Flags) == 0U) || ((s2if & Ack_Mask) != 0U)) {
+        ret = LSM6DSO16IS_STATUS_OK;
+        break;
+      }
+      if ((lsm6dso16is_time_us() - start_us) >= Timeout_us) {
+        break;
+      }
+      /* Torna al banco principale durante l'attesa: il bus resta libero per gli altri thread */
+      if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+        break;
+      }
+      LSM6DSO16IS_BUS_SCOPE_RELEASE();
+      backoff_wait(&backoff_us, LSM6DSO16IS_ISPU_MAILBOX_BACKOFF_MAX_US);
+      LSM6DSO16IS_BUS_SCOPE_ACQUIRE();
+      if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+        break;
+      }
+    }
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (S2if_Flags != NULL) {
+    *S2if_Flags = s2if;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Load an image into the ISPU program and data memories
+  * @note   The ISPU is left in reset: call Start_ISPU() to run the new image.
+  *         Register auto-increment is disabled while streaming, so that burst
+  *         writes to ISPU_MEM_DATA advance the ISPU memory address only; the
+  *         bus lock is held until it is enabled again
+  * @param  Sections image sections to be written
+  * @param  Count number of sections
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Load_ISPU_Image(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_IMAGE);
+  LSM6DSO16IS_Lock_Guard lock(*this);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  uint32_t offset;
+  uint16_t len;
+
+  if (Reset_ISPU() != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (auto_increment_set(PROPERTY_DISABLE) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  for (uint8_t i = 0; (i < Count) && (ret == LSM6DSO16IS_STATUS_OK); i++) {
+    if (ispu_mem_select(Sections[i].mem_sel, PROPERTY_DISABLE, Sections[i].address) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+      break;
+    }
+    for (offset = 0; offset < Sections[i].len; offset += len) {
+      len = ((Sections[i].len - offset) > LSM6DSO16IS_ISPU_MEM_CHUNK) ? LSM6DSO16IS_ISPU_MEM_CHUNK
+            : (uint16_t)(Sections[i].len - offset);
+      if (writeRegister(LSM6DSO16IS_ISPU_MEM_DATA, &Sections[i].data[offset], len) != LSM6DSO16IS_STATUS_OK) {
+        ret = LSM6DSO16IS_STATUS_ERROR;
+        break;
+      }
+    }
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (auto_increment_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Compute the CRC32 of the memory areas described by an image
+  * @note   The memory is read back with read_mem_en in bursts of
+  *         LSM6DSO16IS_ISPU_MEM_CHUNK bytes and the CRC is updated as the bytes
+  *         arrive, so no image sized buffer is needed. Auto-increment is
+  *         disabled meanwhile, under the bus lock
+  * @param  Sections image sections whose mem_sel, address and len are read back
+  * @param  Count number of sections
+  * @param  Crc pointer where the CRC32 is written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Get_ISPU_Image_CRC(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count, uint32_t *Crc)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_IMAGE);
+  LSM6DSO16IS_Lock_Guard lock(*this);
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+  uint8_t buff[LSM6DSO16IS_ISPU_MEM_CHUNK];
+  uint32_t crc = 0xFFFFFFFFU;
+  uint32_t offset;
+  uint16_t len;
+
+  if (auto_increment_set(PROPERTY_DISABLE) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  for (uint8_t i = 0; (i < Count) && (ret == LSM6DSO16IS_STATUS_OK); i++) {
+    if (ispu_mem_select(Sections[i].mem_sel, PROPERTY_ENABLE, Sections[i].address) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+      break;
+    }
+    for (offset = 0; offset < Sections[i].len; offset += len) {
+      len = ((Sections[i].len - offset) > LSM6DSO16IS_ISPU_MEM_CHUNK) ? LSM6DSO16IS_ISPU_MEM_CHUNK
+            : (uint16_t)(Sections[i].len - offset);
+      if (readRegister(LSM6DSO16IS_ISPU_MEM_DATA, buff, len) != LSM6DSO16IS_STATUS_OK) {
+        ret = LSM6DSO16IS_STATUS_ERROR;
+        break;
+      }
+      crc = crc32_update(crc, buff, len);
+    }
+  }
+
+  /* Leave the memory interface in write mode. */
+  if (ret == LSM6DSO16IS_STATUS_OK) {
+    if (ispu_mem_select(LSM6DSO16IS_ISPU_DATA_RAM, PROPERTY_DISABLE, 0) != LSM6DSO16IS_STATUS_OK) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
+    }
+  }
+
+  if (mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+  if (auto_increment_set(PROPERTY_ENABLE) != LSM6DSO16IS_STATUS_OK) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  *Crc = ~crc;
+  return ret;
+}
+
+/**
+  * @brief  Boot the ISPU, loading the image only if the resident one differs
+  * @note   The CRC of the ISPU memory is compared with the CRC of the image: on
+  *         a match a running ISPU is left untouched, and a stopped one is only
+  *         started
+  * @param  Sections image sections
+  * @param  Count number of sections
+  * @param  Force 1 to always reload the image
+  * @param  Reloaded pointer where 1 is written if the image was loaded, may be NULL
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::Boot_ISPU_Image(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count,
+                                                     uint8_t Force, uint8_t *Reloaded)
+{
+  LSM6DSO16IS_BUS_SCOPE(LSM6DSO16IS_API_ISPU_IMAGE);
+  uint32_t device_crc = 0;
+  uint8_t boot_end = 0;
+  uint8_t reload = 1;
+
+  if (Force == 0U) {
+    if (Get_ISPU_Image_CRC(Sections, Count, &device_crc) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+    reload = (device_crc == ISPU_Image_CRC(Sections, Count)) ? 0U : 1U;
+  }
+
+  if (Reloaded != NULL) {
+    *Reloaded = reload;
+  }
+
+  if (reload == 0U) {
+    if (ispu_boot_end_get(&boot_end) != LSM6DSO16IS_STATUS_OK) {
+      return LSM6DSO16IS_STATUS_ERROR;
+    }
+    if (boot_end == 1U) {
+      return LSM6DSO16IS_STATUS_OK;
+    }
+  } else if (Load_ISPU_Image(Sections, Count) != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  if (Start_ISPU() != LSM6DSO16IS_STATUS_OK) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
+
+  return Wait_ISPU_Boot(LSM6DSO16IS_ISPU_BOOT_TIMEOUT_MS);
+}
+
+/**
+  * @brief  Compute the CRC32 of an ISPU image held in MCU memory
+  * @note   The result matches Get_ISPU_Image_CRC() when the image is resident,
+  *         and can be precomputed at build time
+  * @param  Sections image sections
+  * @param  Count number of sections
+  * @retval the CRC32 (IEEE 802.3) of the concatenated section data
+  */
+uint32_t LSM6DSO16IS::ISPU_Image_CRC(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count)
+{
+  uint32_t crc = 0xFFFFFFFFU;
+
+  for (uint8_t i = 0; i < Count; i++) {
+    crc = crc32_update(crc, Sections[i].data, Sections[i].len);
+  }
+
+  return ~crc;
+}
+
+/* Utility */
 
 float_t LSM6DSO16IS::from_fs2g_to_mg(int16_t lsb)
 {
   return ((float_t)lsb * 0.061f);
 }
 
-float_t LSM6DSO16IS::from_fs4g_to_mg(int16_t lsb)
+float_t LSM6DSO16IS::from_fs4g_to_mg(int16_t lsb)
+{
+  return ((float_t)lsb * 0.122f);
+}
+
+float_t LSM6DSO16IS::from_fs8g_to_mg(int16_t lsb)
+{
+  return ((float_t)lsb * 0.244f);
+}
+
+float_t LSM6DSO16IS::from_fs16g_to_mg(int16_t lsb)
+{
+  return ((float_t)lsb * 0.488f);
+}
+
+float_t LSM6DSO16IS::from_fs125dps_to_mdps(int16_t lsb)
+{
+  return ((float_t)lsb * 4.375f);
+}
+
+float_t LSM6DSO16IS::from_fs250dps_to_mdps(int16_t lsb)
+{
+  return ((float_t)lsb * 8.75f);
+}
+
+float_t LSM6DSO16IS::from_fs500dps_to_mdps(int16_t lsb)
+{
+  return ((float_t)lsb * 17.50f);
+}
+
+float_t LSM6DSO16IS::from_fs1000dps_to_mdps(int16_t lsb)
+{
+  return ((float_t)lsb * 35.0f);
+}
+
+float_t LSM6DSO16IS::from_fs2000dps_to_mdps(int16_t lsb)
+{
+  return ((float_t)lsb * 70.0f);
+}
+
+float_t LSM6DSO16IS::from_lsb_to_celsius(int16_t lsb)
+{
+  return (((float_t)lsb / 256.0f) + 25.0f);
+}
+
+
+void LSM6DSO16IS::readSensorData() {
+    // Leggi i dati dal sensore
+#ifndef LSM6DSO16IS_HOST_BUILD
+    if (i2c) {
+        // Lettura specifica per I2C
+    } else if (spi) {
+        // Lettura specifica per SPI
+    }
+#endif
+}
+
+/********************************************************************/
+int32_t LSM6DSO16IS::xl_data_rate_set(lsm6dso16is_xl_data_rate_t val)
+{
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+
+  if (ret == 0) {
+    if (((uint8_t)val & 0x10U) == 0x10U) {
+      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
+    } else {
+      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
+    }
+
+    ctrl1_xl.odr_xl = ((uint8_t)val & 0xfU);
+    ret += writeRegister(LSM6DSO16IS_CTRL1_XL, reinterpret_cast<const uint8_t*>(&ctrl1_xl), sizeof(ctrl1_xl));
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::xl_hm_mode_set(lsm6dso16is_hm_mode_t val)
+{
+  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL6_C, (uint8_t *)&ctrl6_c, 1);
+
+  if (ret == 0) {
+    ctrl6_c.xl_hm_mode = ((uint8_t)val & 0x1U);
+    ret = writeRegister(LSM6DSO16IS_CTRL6_C, reinterpret_cast<const uint8_t*>(&ctrl6_c), sizeof(ctrl6_c));
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::gy_data_rate_set(lsm6dso16is_gy_data_rate_t val)
+{
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+
+  if (ret == 0) {
+    if (((uint8_t)val & 0x10U) == 0x10U) {
+      ret += gy_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
+    } else {
+      ret += gy_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
+    }
+
+    ctrl2_g.odr_g = ((uint8_t)val & 0xfU);
+    ret += writeRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::gy_hm_mode_set(lsm6dso16is_hm_mode_t val)
+{
+  lsm6dso16is_ctrl7_g_t ctrl7_g;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+
+  if (ret == 0) {
+    ctrl7_g.g_hm_mode = ((uint8_t)val & 0x1U);
+    ret = writeRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::acceleration_raw_get(int16_t *val)
+{
+  uint8_t buff[6];
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_OUTX_L_A, buff, 6);
+  val[0] = (int16_t)buff[1];
+  val[0] = (val[0] * 256) + (int16_t)buff[0];
+  val[1] = (int16_t)buff[3];
+  val[1] = (val[1] * 256) + (int16_t)buff[2];
+  val[2] = (int16_t)buff[5];
+  val[2] = (val[2] * 256) + (int16_t)buff[4];
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::auto_increment_set(uint8_t val)
+{
+  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+
+  if (ret == 0) {
+    ctrl3_c.if_inc = val;
+    ret = writeRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::block_data_update_set(uint8_t val)
+{
+  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+
+  if (ret == 0) {
+    ctrl3_c.bdu = val;
+    ret = writeRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::data_rate_set(lsm6dso16is_xl_data_rate_t val)
+{
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+
+  if (ret == 0) {
+    if (((uint8_t)val & 0x10U) == 0x10U) {
+      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
+    } else {
+      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
+    }
+
+    ctrl1_xl.odr_xl = ((uint8_t)val & 0xfU);
+    ret += writeRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::xl_full_scale_set(lsm6dso16is_xl_full_scale_t val)
+{
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+
+  if (ret == 0) {
+    ctrl1_xl.fs_xl = ((uint8_t)val & 0x3U);
+    ret = writeRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  }
+
+  return ret;
+}
+
+int32_t LSM6DSO16IS::gy_full_scale_set(lsm6dso16is_gy_full_scale_t val)
 {
-  return ((float_t)lsb * 0.122f);
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  int32_t ret;
+\
+  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+
+  if (ret == 0) {
+    ctrl2_g.fs_g = ((uint8_t)val & 0x3U);
+    ctrl2_g.fs_125 = ((uint8_t)val >> 4);
+    ret = writeRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+  }
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs8g_to_mg(int16_t lsb)
+int32_t LSM6DSO16IS::xl_full_scale_get(lsm6dso16is_xl_full_scale_t *val)
 {
-  return ((float_t)lsb * 0.244f);
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  *val = (lsm6dso16is_xl_full_scale_t)ctrl1_xl.fs_xl;
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs16g_to_mg(int16_t lsb)
+int32_t LSM6DSO16IS::xl_data_rate_get(lsm6dso16is_xl_data_rate_t *val)
 {
-  return ((float_t)lsb * 0.488f);
+  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  uint8_t code;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_CTRL6_C, (uint8_t *)&ctrl6_c, 1);
+  }
+
+  code = (uint8_t)((ctrl6_c.xl_hm_mode << 4) | (ctrl1_xl.odr_xl));
+  *val = (lsm6dso16is_xl_odr_hz(code) < 0.0f) ? LSM6DSO16IS_XL_ODR_OFF : (lsm6dso16is_xl_data_rate_t)code;
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs125dps_to_mdps(int16_t lsb)
+int32_t LSM6DSO16IS::gy_full_scale_get(lsm6dso16is_gy_full_scale_t *val)
 {
-  return ((float_t)lsb * 4.375f);
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+  *val = (ctrl2_g.fs_125 != 0U) ? LSM6DSO16IS_125dps : (lsm6dso16is_gy_full_scale_t)ctrl2_g.fs_g;
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs250dps_to_mdps(int16_t lsb)
+int32_t LSM6DSO16IS::gy_data_rate_get(lsm6dso16is_gy_data_rate_t *val)
 {
-  return ((float_t)lsb * 8.75f);
+  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_ctrl7_g_t ctrl7_g;
+  uint8_t code;
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+  }
+
+  code = (uint8_t)((ctrl7_g.g_hm_mode << 4) | (ctrl2_g.odr_g));
+  *val = (lsm6dso16is_gy_odr_hz(code) < 0.0f) ? LSM6DSO16IS_GY_ODR_OFF : (lsm6dso16is_gy_data_rate_t)code;
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs500dps_to_mdps(int16_t lsb)
+int32_t LSM6DSO16IS::angular_rate_raw_get(int16_t *val)
 {
-  return ((float_t)lsb * 17.50f);
+  uint8_t buff[6];
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_OUTX_L_G, buff, 6);
+  val[0] = (int16_t)buff[1];
+  val[0] = (val[0] * 256) + (int16_t)buff[0];
+  val[1] = (int16_t)buff[3];
+  val[1] = (val[1] * 256) + (int16_t)buff[2];
+  val[2] = (int16_t)buff[5];
+  val[2] = (val[2] * 256) + (int16_t)buff[4];
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs1000dps_to_mdps(int16_t lsb)
+int32_t LSM6DSO16IS::ia_ispu_get(uint32_t *val)
 {
-  return ((float_t)lsb * 35.0f);
+  uint8_t buff[4];
+  int32_t ret;
+
+  ret = readRegister(LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE, &buff[0], 4);
+
+  *val = (uint32_t)buff[3];
+  *val = (*val * 256U) + (uint32_t)buff[2];
+  *val = (*val * 256U) + (uint32_t)buff[1];
+  *val = (*val * 256U) + (uint32_t)buff[0];
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_fs2000dps_to_mdps(int16_t lsb)
+int32_t LSM6DSO16IS::mem_bank_set(lsm6dso16is_mem_bank_t val)
 {
-  return ((float_t)lsb * 70.0f);
+  lsm6dso16is_func_cfg_access_t func_cfg_access;
+  int32_t ret;
+
+  Lock();
+
+  ret = readRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+
+  if (ret == 0) {
+    func_cfg_access.shub_reg_access = (val == LSM6DSO16IS_SENSOR_HUB_MEM_BANK) ? 0x1U : 0x0U;
+    func_cfg_access.ispu_reg_access = (val == LSM6DSO16IS_ISPU_MEM_BANK) ? 0x1U : 0x0U;
+    ret = writeRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+  }
+
+  /* If the main bank cannot be restored the bank is unknown: the next
+     access, from any thread, retries the switch and fails if it fails again. */
+  if (val == LSM6DSO16IS_MAIN_MEM_BANK) {
+    bank_fault = (ret != 0) ? 1U : 0U;
+  }
+
+#ifdef LSM6DSO16IS_THREAD_SAFE
+  /* Keep the lock while another bank is selected; callers always switch back
+     to the main bank, also on error, but not if leaving it failed. */
+  if (val != LSM6DSO16IS_MAIN_MEM_BANK) {
+    if ((ret == 0) && (bank_lock_held == 0U)) {
+      bank_lock_held = 1;
+      Lock();
+    }
+  } else if (bank_lock_held != 0U) {
+    bank_lock_held = 0;
+    Unlock();
+  }
+#endif
+
+  Unlock();
+
+  return ret;
 }
 
-float_t LSM6DSO16IS::from_lsb_to_celsius(int16_t lsb)
+int32_t LSM6DSO16IS::main_bank_ensure(void)
 {
-  return (((float_t)lsb / 256.0f) + 25.0f);
-}
+  lsm6dso16is_func_cfg_access_t func_cfg_access;
+  int32_t ret;
 
+  /* Dopo un reset dell'MCU il sensore puo' essere rimasto su un altro banco */
+  ret = readRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+  if ((ret == 0) && ((func_cfg_access.shub_reg_access != 0U) || (func_cfg_access.ispu_reg_access != 0U))) {
+    ret = mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK);
+  }
 
-void LSM6DSO16IS::readSensorData() {
-    // Leggi i dati dal sensore
-    if (i2c) {
-        // Lettura specifica per I2C
-    } else if (spi) {
-        // Lettura specifica per SPI
-    }
+  return ret;
 }
 
-/********************************************************************/
-int32_t LSM6DSO16IS::xl_data_rate_set(lsm6dso16is_xl_data_rate_t val)
+int32_t LSM6DSO16IS::bank_fault_recover(void)
 {
-  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_func_cfg_access_t func_cfg_access;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  if (bank_fault == 0U) {
+    return 0;
+  }
 
+  ret = readRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
   if (ret == 0) {
-    if (((uint8_t)val & 0x10U) == 0x10U) {
-      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
-    } else {
-      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
-    }
-
-    ctrl1_xl.odr_xl = ((uint8_t)val & 0xfU);
-    ret += writeRegister(LSM6DSO16IS_CTRL1_XL, reinterpret_cast<const uint8_t*>(&ctrl1_xl), sizeof(ctrl1_xl));
+    func_cfg_access.shub_reg_access = 0x0U;
+    func_cfg_access.ispu_reg_access = 0x0U;
+    ret = writeRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+  }
+  if (ret == 0) {
+    bank_fault = 0;
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::xl_hm_mode_set(lsm6dso16is_hm_mode_t val)
+int32_t LSM6DSO16IS::ispu_boot_end_get(uint8_t *val)
 {
-  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  lsm6dso16is_ispu_status_t ispu_status;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL6_C, (uint8_t *)&ctrl6_c, 1);
+  ret = mem_bank_set(LSM6DSO16IS_ISPU_MEM_BANK);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_ISPU_STATUS, (uint8_t *)&ispu_status, 1);
+    ret += mem_bank_set(LSM6DSO16IS_MAIN_MEM_BANK);
+  }
 
   if (ret == 0) {
-    ctrl6_c.xl_hm_mode = ((uint8_t)val & 0x1U);
-    ret = writeRegister(LSM6DSO16IS_CTRL6_C, reinterpret_cast<const uint8_t*>(&ctrl6_c), sizeof(ctrl6_c));
+    *val = ispu_status.boot_end;
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::gy_data_rate_set(lsm6dso16is_gy_data_rate_t val)
+int32_t LSM6DSO16IS::int1_boot_set(uint8_t val)
 {
-  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_int1_ctrl_t int1_ctrl;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+  ret = readRegister(LSM6DSO16IS_INT1_CTRL, (uint8_t *)&int1_ctrl, 1);
 
   if (ret == 0) {
-    if (((uint8_t)val & 0x10U) == 0x10U) {
-      ret += gy_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
+    int1_ctrl.int1_boot = val;
+    ret = writeRegister(LSM6DSO16IS_INT1_CTRL, (uint8_t *)&int1_ctrl, 1);
+  }
+
+  return ret;
+}
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+void LSM6DSO16IS::int1_isr(void)
+{
+  uint32_t timestamp;
+
+#if DEVICE_SPI_ASYNCH
+  if (dma_on_int1()) {
+    Notify_DRDY();
+    dma_trigger();
+    return;
+  }
+#endif
+
+  /* Il fronte di fine boot dell'ISPU non e' un data-ready */
+  if (((ispu_boot_pending == 0U) || (ispu_boot_irq == 0U)) && (drdy_queue[LSM6DSO16IS_INT1_PIN] != NULL)) {
+    Notify_DRDY();
+  }
+
+  timestamp = lsm6dso16is_time_us();
+
+  if (ispu_boot_pending != 0U) {
+    ispu_boot_flags.set(LSM6DSO16IS_ISPU_BOOT_FLAG);
+  }
+
+  drdy_post(LSM6DSO16IS_INT1_PIN, timestamp);
+}
+
+void LSM6DSO16IS::int2_isr(void)
+{
+#if DEVICE_SPI_ASYNCH
+  if ((dma_active != 0U) && (dma_pin == LSM6DSO16IS_INT2_PIN)) {
+    Notify_DRDY();
+    dma_trigger();
+    return;
+  }
+#endif
+
+  if (drdy_queue[LSM6DSO16IS_INT2_PIN] != NULL) {
+    Notify_DRDY();
+  }
+
+  drdy_post(LSM6DSO16IS_INT2_PIN, lsm6dso16is_time_us());
+}
+
+void LSM6DSO16IS::drdy_post(LSM6DSO16IS_SensorIntPin_t pin, uint32_t timestamp)
+{
+  /* Only timestamp here: the output registers are read by the handler in the queue thread. */
+  if (drdy_queue[pin] != NULL) {
+    if (drdy_queue[pin]->call(drdy_handler[pin], timestamp) != 0) {
+      drdy_captured[pin]++;
     } else {
-      ret += gy_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
+      drdy_dropped[pin]++;
     }
+  }
+}
 
-    ctrl2_g.odr_g = ((uint8_t)val & 0xfU);
-    ret += writeRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+InterruptIn *LSM6DSO16IS::int_pin_get(LSM6DSO16IS_SensorIntPin_t pin)
+{
+  return (pin == LSM6DSO16IS_INT1_PIN) ? int1_pin : int2_pin;
+}
+
+bool LSM6DSO16IS::dma_on_int1(void)
+{
+#if DEVICE_SPI_ASYNCH
+  return (dma_active != 0U) && (dma_pin == LSM6DSO16IS_INT1_PIN);
+#else
+  return false;
+#endif
+}
+
+int32_t LSM6DSO16IS::dma_pause(InterruptIn **pin)
+{
+  *pin = NULL;
+
+#if DEVICE_SPI_ASYNCH
+  uint32_t start_us;
+
+  if (dma_active == 0U) {
+    return 0;
   }
 
-  return ret;
+  /* No new DMA read may start, and the one in flight must end, before the
+     blocking transfer takes the bus. The pin stays disabled also on error:
+     the caller re-enables it with dma_resume(). */
+  *pin = int_pin_get(dma_pin);
+  (*pin)->disable_irq();
+  start_us = lsm6dso16is_time_us();
+  while (dma_busy != 0U) {
+    if ((lsm6dso16is_time_us() - start_us) >= LSM6DSO16IS_DMA_PAUSE_TIMEOUT_US) {
+      /* Transfer stuck: free the bus, the sample is read again at the next edge. */
+      spi->abort_transfer();
+      cs_pin->write(1);
+      dma_busy = 0;
+      dma_overruns++;
+      return 1;
+    }
+  }
+#endif
+
+  return 0;
 }
 
-int32_t LSM6DSO16IS::gy_hm_mode_set(lsm6dso16is_hm_mode_t val)
+void LSM6DSO16IS::dma_resume(InterruptIn *pin)
 {
-  lsm6dso16is_ctrl7_g_t ctrl7_g;
-  int32_t ret;
+  if (pin != NULL) {
+    pin->enable_irq();
+  }
+}
 
-  ret = readRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+#if DEVICE_SPI_ASYNCH
+void LSM6DSO16IS::dma_trigger(void)
+{
+  uint8_t *slot;
 
-  if (ret == 0) {
-    ctrl7_g.g_hm_mode = ((uint8_t)val & 0x1U);
-    ret = writeRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+  if (dma_busy != 0U) {
+    dma_overruns++;
+    return;
   }
 
-  return ret;
+  dma_busy = 1;
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  drdy_read_start(LSM6DSO16IS_OUTX_L_G);
+  dma_start = lsm6dso16is_cycles();
+#endif
+  slot = dma_buf[dma_fill] + ((uint32_t)dma_index * LSM6DSO16IS_DMA_SAMPLE_SIZE);
+  cs_pin->write(0);
+  if (spi->transfer(dma_tx, LSM6DSO16IS_DMA_SAMPLE_SIZE, slot, LSM6DSO16IS_DMA_SAMPLE_SIZE,
+                    callback(this, &LSM6DSO16IS::dma_done), SPI_EVENT_COMPLETE) != 0) {
+    cs_pin->write(1);
+    dma_busy = 0;
+    dma_overruns++;
+  }
 }
 
-int32_t LSM6DSO16IS::acceleration_raw_get(int16_t *val)
+void LSM6DSO16IS::dma_done(int event)
 {
-  uint8_t buff[6];
+  uint8_t other;
+
+  (void)event;
+  cs_pin->write(1);
+  dma_busy = 0;
+#ifdef LSM6DSO16IS_LATENCY_HIST
+  latency[LSM6DSO16IS_LATENCY_BUS_TRANSFER].Record(lsm6dso16is_cycles() - dma_start);
+#endif
+
+  if (++dma_index < dma_samples) {
+    return;
+  }
+  dma_index = 0;
+
+  /* Swap only if the other buffer has been handed back; otherwise the block
+     just completed is dropped and refilled. */
+  other = dma_fill ^ 1U;
+  if (dma_pending[other] != 0U) {
+    dma_overruns++;
+    return;
+  }
+
+  dma_pending[dma_fill] = 1;
+  if (dma_queue->call(callback(this, &LSM6DSO16IS::dma_block), (uint8_t)dma_fill) == 0) {
+    dma_pending[dma_fill] = 0;
+    dma_overruns++;
+    return;
+  }
+  dma_blocks++;
+  dma_fill = other;
+}
+
+void LSM6DSO16IS::dma_block(uint8_t index)
+{
+  dma_handler(dma_buf[index], dma_samples);
+  dma_pending[index] = 0;
+}
+#endif
+#endif
+
+int32_t LSM6DSO16IS::mailbox_words_write(const uint16_t *words, uint8_t count)
+{
+  uint8_t buff[8];
+
+  if (count > 4U) {
+    return 1;
+  }
+  if (count == 0U) {
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    buff[(2U * i)]      = (uint8_t)(words[i] & 0xFFU);
+    buff[(2U * i) + 1U] = (uint8_t)(words[i] >> 8);
+  }
+
+  return writeRegister(LSM6DSO16IS_ISPU_DUMMY_CFG_1_L, buff, (uint16_t)(2U * count));
+}
+
+int32_t LSM6DSO16IS::mailbox_if2s_write(uint16_t val)
+{
+  uint8_t buff[2];
+
+  buff[0] = (uint8_t)(val & 0xFFU);
+  buff[1] = (uint8_t)(val >> 8);
+
+  return writeRegister(LSM6DSO16IS_ISPU_IF2S_FLAG_L, buff, 2);
+}
+
+int32_t LSM6DSO16IS::mailbox_flags_get(uint16_t *if2s, uint16_t *s2if)
+{
+  uint8_t buff[4];
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_OUTX_L_A, buff, 6);
-  val[0] = (int16_t)buff[1];
-  val[0] = (val[0] * 256) + (int16_t)buff[0];
-  val[1] = (int16_t)buff[3];
-  val[1] = (val[1] * 256) + (int16_t)buff[2];
-  val[2] = (int16_t)buff[5];
-  val[2] = (val[2] * 256) + (int16_t)buff[4];
+  ret = readRegister(LSM6DSO16IS_ISPU_IF2S_FLAG_L, buff, 4);
+
+  *if2s = (uint16_t)buff[1];
+  *if2s = (*if2s * 256U) + (uint16_t)buff[0];
+  *s2if = (uint16_t)buff[3];
+  *s2if = (*s2if * 256U) + (uint16_t)buff[2];
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::auto_increment_set(uint8_t val)
+void LSM6DSO16IS::backoff_wait(uint32_t *backoff_us, uint32_t max_us)
+{
+  lsm6dso16is_delay_us(*backoff_us);
+  if (*backoff_us < max_us) {
+    *backoff_us *= 2U;
+  }
+}
+
+int32_t LSM6DSO16IS::ispu_mem_select(lsm6dso16is_ispu_mem_sel_val_t mem_sel, uint8_t read_en, uint16_t addr)
 {
-  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  lsm6dso16is_ispu_mem_sel_t ispu_mem_sel;
+  uint8_t addr1 = (uint8_t)(addr >> 8);
+  uint8_t addr0 = (uint8_t)(addr & 0xFFU);
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
-
+  memset(&ispu_mem_sel, 0, sizeof(ispu_mem_sel));
+  /* Single byte writes: auto-increment is disabled while streaming ISPU memory. */
+  ispu_mem_sel.mem_sel = (uint8_t)mem_sel;
+  ispu_mem_sel.read_mem_en = read_en;
+  ret = writeRegister(LSM6DSO16IS_ISPU_MEM_SEL, (uint8_t *)&ispu_mem_sel, 1);
   if (ret == 0) {
-    ctrl3_c.if_inc = val;
-    ret = writeRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+    ret = writeRegister(LSM6DSO16IS_ISPU_MEM_ADDR1, &addr1, 1);
+  }
+  if (ret == 0) {
+    ret = writeRegister(LSM6DSO16IS_ISPU_MEM_ADDR0, &addr0, 1);
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::block_data_update_set(uint8_t val)
+uint32_t LSM6DSO16IS::crc32_update(uint32_t crc, const uint8_t *data, uint32_t len)
 {
-  lsm6dso16is_ctrl3_c_t ctrl3_c;
+  /* Nibble table: 64 bytes of flash, two lookups per byte. */
+  static const uint32_t crc32_nibble[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+  };
+
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ crc32_nibble[crc & 0x0FU];
+    crc = (crc >> 4) ^ crc32_nibble[crc & 0x0FU];
+  }
+
+  return crc;
+}
+
+int32_t LSM6DSO16IS::pin_int1_route_get(lsm6dso16is_pin_int1_route_t *val)
+{
+  lsm6dso16is_int1_ctrl_t int1_ctrl;
+  lsm6dso16is_md1_cfg_t md1_cfg;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+  ret = readRegister(LSM6DSO16IS_INT1_CTRL, (uint8_t *)&int1_ctrl, 1);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_MD1_CFG, (uint8_t *)&md1_cfg, 1);
+  }
 
   if (ret == 0) {
-    ctrl3_c.bdu = val;
-    ret = writeRegister(LSM6DSO16IS_CTRL3_C, (uint8_t *)&ctrl3_c, 1);
+    val->drdy_xl = int1_ctrl.int1_drdy_xl;
+    val->drdy_gy = int1_ctrl.int1_drdy_g;
+    val->boot = int1_ctrl.int1_boot;
+    val->sh_endop = md1_cfg.int1_shub;
+    val->ispu = md1_cfg.int1_ispu;
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::data_rate_set(lsm6dso16is_xl_data_rate_t val)
+int32_t LSM6DSO16IS::pin_int1_route_set(lsm6dso16is_pin_int1_route_t val)
 {
-  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_int1_ctrl_t int1_ctrl;
+  lsm6dso16is_md1_cfg_t md1_cfg;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  ret = readRegister(LSM6DSO16IS_INT1_CTRL, (uint8_t *)&int1_ctrl, 1);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_MD1_CFG, (uint8_t *)&md1_cfg, 1);
+  }
 
   if (ret == 0) {
-    if (((uint8_t)val & 0x10U) == 0x10U) {
-      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_DISABLED);
-    } else {
-      ret += xl_hm_mode_set(LSM6DSO16IS_HIGH_PERFOMANCE_MODE_ENABLED);
-    }
+    int1_ctrl.int1_drdy_xl = val.drdy_xl;
+    int1_ctrl.int1_drdy_g = val.drdy_gy;
+    int1_ctrl.int1_boot = val.boot;
+    ret = writeRegister(LSM6DSO16IS_INT1_CTRL, (uint8_t *)&int1_ctrl, 1);
+  }
 
-    ctrl1_xl.odr_xl = ((uint8_t)val & 0xfU);
-    ret += writeRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  if (ret == 0) {
+    md1_cfg.int1_shub = val.sh_endop;
+    md1_cfg.int1_ispu = val.ispu;
+    ret = writeRegister(LSM6DSO16IS_MD1_CFG, (uint8_t *)&md1_cfg, 1);
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::xl_full_scale_set(lsm6dso16is_xl_full_scale_t val)
+int32_t LSM6DSO16IS::data_ready_mode_set(lsm6dso16is_data_ready_mode_t val)
 {
-  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_drdy_pulsed_reg_t drdy_pulsed_reg;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  ret = readRegister(LSM6DSO16IS_DRDY_PULSED_REG, (uint8_t *)&drdy_pulsed_reg, 1);
 
   if (ret == 0) {
-    ctrl1_xl.fs_xl = ((uint8_t)val & 0x3U);
-    ret = writeRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+    drdy_pulsed_reg.drdy_pulsed = ((uint8_t)val & 0x1U);
+    ret = writeRegister(LSM6DSO16IS_DRDY_PULSED_REG, (uint8_t *)&drdy_pulsed_reg, 1);
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::gy_full_scale_set(lsm6dso16is_gy_full_scale_t val)
+int32_t LSM6DSO16IS::pin_int2_route_get(lsm6dso16is_pin_int2_route_t *val)
 {
-  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_int2_ctrl_t int2_ctrl;
+  lsm6dso16is_md2_cfg_t md2_cfg;
   int32_t ret;
-\
-  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
 
+  ret = readRegister(LSM6DSO16IS_INT2_CTRL, (uint8_t *)&int2_ctrl, 1);
   if (ret == 0) {
-    ctrl2_g.fs_g = ((uint8_t)val & 0x3U);
-    ctrl2_g.fs_125 = ((uint8_t)val >> 4);
-    ret = writeRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
+    ret = readRegister(LSM6DSO16IS_MD2_CFG, (uint8_t *)&md2_cfg, 1);
+  }
+
+  if (ret == 0) {
+    val->drdy_xl = int2_ctrl.int2_drdy_xl;
+    val->drdy_gy = int2_ctrl.int2_drdy_g;
+    val->drdy_temp = int2_ctrl.int2_drdy_temp;
+    val->ispu_sleep = int2_ctrl.int2_sleep_ispu;
+    val->ispu = md2_cfg.int2_ispu;
+    val->timestamp = md2_cfg.int2_timestamp;
   }
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::xl_full_scale_get(lsm6dso16is_xl_full_scale_t *val)
+int32_t LSM6DSO16IS::pin_int2_route_set(lsm6dso16is_pin_int2_route_t val)
 {
-  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
+  lsm6dso16is_int2_ctrl_t int2_ctrl;
+  lsm6dso16is_md2_cfg_t md2_cfg;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
-
-  switch ((ctrl1_xl.fs_xl)) {
-    case LSM6DSO16IS_2g:
-      *val = LSM6DSO16IS_2g;
-      break;
-
-    case LSM6DSO16IS_4g:
-      *val = LSM6DSO16IS_4g;
-      break;
-
-    case LSM6DSO16IS_8g:
-      *val = LSM6DSO16IS_8g;
-      break;
+  ret = readRegister(LSM6DSO16IS_INT2_CTRL, (uint8_t *)&int2_ctrl, 1);
+  if (ret == 0) {
+    ret = readRegister(LSM6DSO16IS_MD2_CFG, (uint8_t *)&md2_cfg, 1);
+  }
 
-    case LSM6DSO16IS_16g:
-      *val = LSM6DSO16IS_16g;
-      break;
+  if (ret == 0) {
+    int2_ctrl.int2_drdy_xl = val.drdy_xl;
+    int2_ctrl.int2_drdy_g = val.drdy_gy;
+    int2_ctrl.int2_drdy_temp = val.drdy_temp;
+    int2_ctrl.int2_sleep_ispu = val.ispu_sleep;
+    ret = writeRegister(LSM6DSO16IS_INT2_CTRL, (uint8_t *)&int2_ctrl, 1);
+  }
 
-    default:
-      *val = LSM6DSO16IS_2g;
-      break;
+  if (ret == 0) {
+    md2_cfg.int2_ispu = val.ispu;
+    md2_cfg.int2_timestamp = val.timestamp;
+    ret = writeRegister(LSM6DSO16IS_MD2_CFG, (uint8_t *)&md2_cfg, 1);
   }
+
   return ret;
 }
 
-int32_t LSM6DSO16IS::xl_data_rate_get(lsm6dso16is_xl_data_rate_t *val)
+int32_t LSM6DSO16IS::int2_on_int1_set(uint8_t val)
 {
-  lsm6dso16is_ctrl1_xl_t ctrl1_xl;
-  lsm6dso16is_ctrl6_c_t ctrl6_c;
+  lsm6dso16is_ctrl4_c_t ctrl4_c;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL1_XL, (uint8_t *)&ctrl1_xl, 1);
+  ret = readRegister(LSM6DSO16IS_CTRL4_C, (uint8_t *)&ctrl4_c, 1);
+
   if (ret == 0) {
-    ret = readRegister(LSM6DSO16IS_CTRL6_C, (uint8_t *)&ctrl6_c, 1);
+    ctrl4_c.int2_on_int1 = val;
+    ret = writeRegister(LSM6DSO16IS_CTRL4_C, (uint8_t *)&ctrl4_c, 1);
   }
 
-  switch ((ctrl6_c.xl_hm_mode << 4) | (ctrl1_xl.odr_xl)) {
-    case LSM6DSO16IS_XL_ODR_OFF:
-      *val = LSM6DSO16IS_XL_ODR_OFF;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_12Hz5_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_12Hz5_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_26H_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_26H_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_52Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_52Hz_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_104Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_104Hz_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_208Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_208Hz_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_416Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_416Hz_HP;
-      break;
-
-    case LSM6DSO16IS_XL_ODR_AT_833Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_833Hz_HP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_XL_ODR_AT_1667Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_1667Hz_HP;
-      break;
+int32_t LSM6DSO16IS::timestamp_set(uint8_t val)
+{
+  lsm6dso16is_ctrl10_c_t ctrl10_c;
+  int32_t ret;
 
-    case LSM6DSO16IS_XL_ODR_AT_3333Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_3333Hz_HP;
-      break;
+  ret = readRegister(LSM6DSO16IS_CTRL10_C, (uint8_t *)&ctrl10_c, 1);
 
-    case LSM6DSO16IS_XL_ODR_AT_6667Hz_HP:
-      *val = LSM6DSO16IS_XL_ODR_AT_6667Hz_HP;
-      break;
+  if (ret == 0) {
+    ctrl10_c.timestamp_en = val;
+    ret = writeRegister(LSM6DSO16IS_CTRL10_C, (uint8_t *)&ctrl10_c, 1);
+  }
 
-    case LSM6DSO16IS_XL_ODR_AT_12Hz5_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_12Hz5_LP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_XL_ODR_AT_26H_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_26H_LP;
-      break;
+int32_t LSM6DSO16IS::timestamp_raw_get(uint32_t *val)
+{
+  uint8_t buff[4];
+  int32_t ret;
 
-    case LSM6DSO16IS_XL_ODR_AT_52Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_52Hz_LP;
-      break;
+  ret = readRegister(LSM6DSO16IS_TIMESTAMP0, buff, 4);
+  *val = buff[3];
+  *val = (*val * 256U) + buff[2];
+  *val = (*val * 256U) + buff[1];
+  *val = (*val * 256U) + buff[0];
 
-    case LSM6DSO16IS_XL_ODR_AT_104Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_104Hz_LP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_XL_ODR_AT_208Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_208Hz_LP;
-      break;
+int32_t LSM6DSO16IS::gy_sleep_mode_set(uint8_t val)
+{
+  lsm6dso16is_ctrl4_c_t ctrl4_c;
+  int32_t ret;
 
-    case LSM6DSO16IS_XL_ODR_AT_416Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_416Hz_LP;
-      break;
+  ret = readRegister(LSM6DSO16IS_CTRL4_C, (uint8_t *)&ctrl4_c, 1);
 
-    case LSM6DSO16IS_XL_ODR_AT_833Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_833Hz_LP;
-      break;
+  if (ret == 0) {
+    ctrl4_c.sleep_g = val;
+    ret = writeRegister(LSM6DSO16IS_CTRL4_C, (uint8_t *)&ctrl4_c, 1);
+  }
 
-    case LSM6DSO16IS_XL_ODR_AT_1667Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_1667Hz_LP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_XL_ODR_AT_3333Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_3333Hz_LP;
-      break;
+int32_t LSM6DSO16IS::status_reg_get(lsm6dso16is_status_reg_t *val)
+{
+  return readRegister(LSM6DSO16IS_STATUS_REG, (uint8_t *)val, 1);
+}
 
-    case LSM6DSO16IS_XL_ODR_AT_6667Hz_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_6667Hz_LP;
-      break;
+int32_t LSM6DSO16IS::xl_self_test_set(lsm6dso16is_xl_self_test_t val)
+{
+  lsm6dso16is_ctrl5_c_t ctrl5_c;
+  int32_t ret;
 
-    case LSM6DSO16IS_XL_ODR_AT_1Hz6_LP:
-      *val = LSM6DSO16IS_XL_ODR_AT_1Hz6_LP;
-      break;
+  ret = readRegister(LSM6DSO16IS_CTRL5_C, (uint8_t *)&ctrl5_c, 1);
 
-    default:
-      *val = LSM6DSO16IS_XL_ODR_OFF;
-      break;
+  if (ret == 0) {
+    ctrl5_c.st_xl = ((uint8_t)val & 0x3U);
+    ret = writeRegister(LSM6DSO16IS_CTRL5_C, (uint8_t *)&ctrl5_c, 1);
   }
+
   return ret;
 }
 
-int32_t LSM6DSO16IS::gy_full_scale_get(lsm6dso16is_gy_full_scale_t *val)
+int32_t LSM6DSO16IS::gy_self_test_set(lsm6dso16is_gy_self_test_t val)
 {
-  lsm6dso16is_ctrl2_g_t ctrl2_g;
+  lsm6dso16is_ctrl5_c_t ctrl5_c;
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
-
-  switch ((ctrl2_g.fs_125 << 4) | (ctrl2_g.fs_g)) {
-    case LSM6DSO16IS_125dps:
-      *val = LSM6DSO16IS_125dps;
-      break;
+  ret = readRegister(LSM6DSO16IS_CTRL5_C, (uint8_t *)&ctrl5_c, 1);
 
-    case LSM6DSO16IS_250dps:
-      *val = LSM6DSO16IS_250dps;
-      break;
+  if (ret == 0) {
+    ctrl5_c.st_g = ((uint8_t)val & 0x3U);
+    ret = writeRegister(LSM6DSO16IS_CTRL5_C, (uint8_t *)&ctrl5_c, 1);
+  }
 
-    case LSM6DSO16IS_500dps:
-      *val = LSM6DSO16IS_500dps;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_1000dps:
-      *val = LSM6DSO16IS_1000dps;
-      break;
+int32_t LSM6DSO16IS::self_test_sum(uint8_t xl, uint8_t samples, int32_t *sum)
+{
+  lsm6dso16is_status_reg_t status;
+  int16_t raw[3];
+  uint32_t start_us;
+  int32_t ret;
 
-    case LSM6DSO16IS_2000dps:
-      *val = LSM6DSO16IS_2000dps;
-      break;
+  sum[0] = 0;
+  sum[1] = 0;
+  sum[2] = 0;
+
+  /* The first sample after a configuration change is discarded. */
+  for (uint16_t n = 0; n <= samples; n++) {
+    start_us = lsm6dso16is_time_us();
+    for (;;) {
+      ret = status_reg_get(&status);
+      if (ret != 0) {
+        return ret;
+      }
+      if (((xl != 0U) && (status.xlda == 1U)) || ((xl == 0U) && (status.gda == 1U))) {
+        break;
+      }
+      if ((lsm6dso16is_time_us() - start_us) >= LSM6DSO16IS_ST_SAMPLE_TIMEOUT_US) {
+        return 1;
+      }
+      lsm6dso16is_delay_us(1000U);
+    }
 
-    default:
-      *val = LSM6DSO16IS_125dps;
-      break;
+    ret = (xl != 0U) ? acceleration_raw_get(raw) : angular_rate_raw_get(raw);
+    if (ret != 0) {
+      return ret;
+    }
+    if (n > 0U) {
+      sum[0] += raw[0];
+      sum[1] += raw[1];
+      sum[2] += raw[2];
+    }
   }
-  return ret;
+
+  return 0;
 }
 
-int32_t LSM6DSO16IS::gy_data_rate_get(lsm6dso16is_gy_data_rate_t *val)
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS::self_test_run(uint8_t xl, uint8_t samples,
+                                                    LSM6DSO16IS_SelfTest_Report_t *report)
 {
-  lsm6dso16is_ctrl2_g_t ctrl2_g;
-  lsm6dso16is_ctrl7_g_t ctrl7_g;
-  int32_t ret;
+  uint8_t saved[7];
+  uint8_t ctrl[7] = {0};
+  int32_t nost[3];
+  int32_t st[3];
+  /* Sensitivity as a fraction: 0.122 mg/LSB at 4 g, 70 mdps/LSB at 2000 dps */
+  int64_t sens_num = (xl != 0U) ? 61 : 70;
+  int64_t sens_den = (xl != 0U) ? 500 : 1;
+  int32_t min = (xl != 0U) ? LSM6DSO16IS_XL_ST_MIN_MG : LSM6DSO16IS_G_ST_MIN_MDPS;
+  int32_t max = (xl != 0U) ? LSM6DSO16IS_XL_ST_MAX_MG : LSM6DSO16IS_G_ST_MAX_MDPS;
+  LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
 
-  ret = readRegister(LSM6DSO16IS_CTRL2_G, (uint8_t *)&ctrl2_g, 1);
-  if (ret == 0) {
-    ret = readRegister(LSM6DSO16IS_CTRL7_G, (uint8_t *)&ctrl7_g, 1);
+  if (samples == 0U) {
+    return LSM6DSO16IS_STATUS_ERROR;
   }
 
-  switch ((ctrl7_g.g_hm_mode << 4) | (ctrl2_g.odr_g)) {
-    case LSM6DSO16IS_GY_ODR_OFF:
-      *val = LSM6DSO16IS_GY_ODR_OFF;
-      break;
+  /* CTRL1_XL..CTRL7_G in one burst; CTRL9_C and CTRL10_C are not touched. */
+  if (readRegister(LSM6DSO16IS_CTRL1_XL, saved, sizeof(saved)) != 0) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_12Hz5_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_12Hz5_HP;
-      break;
+  if (xl != 0U) {
+    ctrl[0] = 0x38U;  /* CTRL1_XL: 52 Hz, 4 g */
+  } else {
+    ctrl[1] = 0x5CU;  /* CTRL2_G: 208 Hz, 2000 dps */
+  }
+  /* CTRL3_C: BDU and IF_INC set, interface bits (SIM, PP_OD, H_LACTIVE) kept,
+     BOOT/SW_RESET never written back. */
+  ctrl[2] = (uint8_t)((saved[2] & (uint8_t)~0x81U) | 0x44U);
+  /* CTRL4_C: I2C_DISABLE and INT2_ON_INT1 kept, gyroscope sleep cleared. */
+  ctrl[3] = (uint8_t)(saved[3] & (uint8_t)~0x40U);
+  if (writeRegister(LSM6DSO16IS_CTRL1_XL, ctrl, sizeof(ctrl)) != 0) {
+    return LSM6DSO16IS_STATUS_ERROR;
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_26H_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_26H_HP;
-      break;
+  report->pass = 1;
+  lsm6dso16is_delay_us(LSM6DSO16IS_ST_SETTLE_US);
+  if (self_test_sum(xl, samples, nost) != 0) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_52Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_52Hz_HP;
-      break;
+  for (uint8_t sign = 0; (sign < 2U) && (ret == LSM6DSO16IS_STATUS_OK); sign++) {
+    int32_t *delta = (sign == 0U) ? report->delta_pos : report->delta_neg;
+    uint8_t *pass = (sign == 0U) ? report->pass_pos : report->pass_neg;
+    int32_t err;
 
-    case LSM6DSO16IS_GY_ODR_AT_104Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_104Hz_HP;
+    if (xl != 0U) {
+      err = xl_self_test_set((sign == 0U) ? LSM6DSO16IS_XL_ST_POSITIVE : LSM6DSO16IS_XL_ST_NEGATIVE);
+    } else {
+      err = gy_self_test_set((sign == 0U) ? LSM6DSO16IS_GY_ST_POSITIVE : LSM6DSO16IS_GY_ST_NEGATIVE);
+    }
+    if (err == 0) {
+      lsm6dso16is_delay_us(LSM6DSO16IS_ST_SETTLE_US);
+      err = self_test_sum(xl, samples, st);
+    }
+    if (err != 0) {
+      ret = LSM6DSO16IS_STATUS_ERROR;
       break;
+    }
 
-    case LSM6DSO16IS_GY_ODR_AT_208Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_208Hz_HP;
-      break;
+    for (uint8_t i = 0; i < 3U; i++) {
+      int64_t d = ((int64_t)(st[i] - nost[i]) * sens_num) / (sens_den * samples);
+      int32_t abs_d = (d < 0) ? (int32_t)(-d) : (int32_t)d;
 
-    case LSM6DSO16IS_GY_ODR_AT_416Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_416Hz_HP;
-      break;
+      delta[i] = (int32_t)d;
+      pass[i] = ((abs_d >= min) && (abs_d <= max)) ? 1U : 0U;
+      if (pass[i] == 0U) {
+        report->pass = 0;
+      }
+    }
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_833Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_833Hz_HP;
-      break;
+  /* Restore the configuration, self-test disabled: ST bits are in CTRL5_C. */
+  if (writeRegister(LSM6DSO16IS_CTRL1_XL, saved, sizeof(saved)) != 0) {
+    ret = LSM6DSO16IS_STATUS_ERROR;
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_1667Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_1667Hz_HP;
-      break;
+  if (ret != LSM6DSO16IS_STATUS_OK) {
+    report->pass = 0;
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_3333Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_3333Hz_HP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_GY_ODR_AT_6667Hz_HP:
-      *val = LSM6DSO16IS_GY_ODR_AT_6667Hz_HP;
-      break;
+bool LSM6DSO16IS::config_reg_writable(uint8_t reg)
+{
+  return (reg != LSM6DSO16IS_CONFIG_RESERVED_0) && (reg != LSM6DSO16IS_WHO_AM_I) &&
+         (reg != LSM6DSO16IS_CONFIG_RESERVED_1);
+}
 
-    case LSM6DSO16IS_GY_ODR_AT_12Hz5_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_12Hz5_LP;
-      break;
+void LSM6DSO16IS::config_image_merge(LSM6DSO16IS_Config_Image_t *image)
+{
+  LSM6DSO16IS_Config_Image_t mask;
 
-    case LSM6DSO16IS_GY_ODR_AT_26H_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_26H_LP;
-      break;
+  /* I bit non gestiti dalla configurazione restano quelli del dispositivo */
+  Get_Config_Mask(&mask);
+  for (uint8_t i = 0; i < sizeof(image->reg); i++) {
+    image->reg[i] = (uint8_t)((config_shadow.reg[i] & (uint8_t)~mask.reg[i]) | (image->reg[i] & mask.reg[i]));
+  }
+}
 
-    case LSM6DSO16IS_GY_ODR_AT_52Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_52Hz_LP;
-      break;
+int32_t LSM6DSO16IS::config_image_write(const LSM6DSO16IS_Config_Image_t *image, uint8_t first, uint8_t last)
+{
+  uint8_t reg = first;
+  int32_t ret = 0;
 
-    case LSM6DSO16IS_GY_ODR_AT_104Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_104Hz_LP;
-      break;
+  while ((reg <= last) && (ret == 0)) {
+    uint8_t start;
 
-    case LSM6DSO16IS_GY_ODR_AT_208Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_208Hz_LP;
-      break;
+    if (!config_reg_writable(reg)) {
+      reg++;
+      continue;
+    }
 
-    case LSM6DSO16IS_GY_ODR_AT_416Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_416Hz_LP;
-      break;
+    start = reg;
+    while ((reg <= last) && config_reg_writable(reg)) {
+      reg++;
+    }
+    ret = writeRegister(start, &image->reg[start - LSM6DSO16IS_CONFIG_FIRST_REG], (uint16_t)(reg - start));
+  }
 
-    case LSM6DSO16IS_GY_ODR_AT_833Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_833Hz_LP;
-      break;
+  return ret;
+}
 
-    case LSM6DSO16IS_GY_ODR_AT_1667Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_1667Hz_LP;
-      break;
+void LSM6DSO16IS::config_adopt(const LSM6DSO16IS_Config_t *config, const LSM6DSO16IS_Config_Image_t *image)
+{
+  config_shadow = *image;
+  config_shadow_valid = 1;
+
+  X_Last_Mode = config->xl_mode;
+  G_Last_Mode = config->g_mode;
+  X_isEnabled = (config->xl_odr > 0.0f) ? 1U : 0U;
+  G_isEnabled = (config->g_odr > 0.0f) ? 1U : 0U;
+  if (X_isEnabled != 0U) {
+    X_Last_ODR = config->xl_odr;
+  }
+  if (G_isEnabled != 0U) {
+    G_Last_ODR = config->g_odr;
+  }
+  G_Standby = LSM6DSO16IS_G_ACTIVE;
+}
 
-    case LSM6DSO16IS_GY_ODR_AT_3333Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_3333Hz_LP;
-      break;
+void LSM6DSO16IS::config_shadow_track(uint8_t reg, const uint8_t *value, uint16_t len, bool failed)
+{
+  uint16_t first = reg;
+  uint16_t last = (uint16_t)(reg + len - 1U);
 
-    case LSM6DSO16IS_GY_ODR_AT_6667Hz_LP:
-      *val = LSM6DSO16IS_GY_ODR_AT_6667Hz_LP;
-      break;
+  if (len == 0U) {
+    return;
+  }
 
-    default:
-      *val = LSM6DSO16IS_GY_ODR_OFF;
-      break;
+  /* FUNC_CFG_ACCESS is mapped in every bank: follow the bank switches. */
+  if ((reg == LSM6DSO16IS_FUNC_CFG_ACCESS) && !failed) {
+    main_bank_selected = ((value[0] & 0xC0U) == 0U) ? 1U : 0U;
   }
 
-  return ret;
-}
+  if ((main_bank_selected == 0U) || (last < LSM6DSO16IS_CONFIG_FIRST_REG) || (first > LSM6DSO16IS_CONFIG_LAST_REG)) {
+    return;
+  }
 
-int32_t LSM6DSO16IS::angular_rate_raw_get(int16_t *val)
-{
-  uint8_t buff[6];
-  int32_t ret;
+  /* After a failed write the device state is unknown. */
+  if (failed) {
+    config_shadow_valid = 0;
+    return;
+  }
 
-  ret = readRegister(LSM6DSO16IS_OUTX_L_G, buff, 6);
-  val[0] = (int16_t)buff[1];
-  val[0] = (val[0] * 256) + (int16_t)buff[0];
-  val[1] = (int16_t)buff[3];
-  val[1] = (val[1] * 256) + (int16_t)buff[2];
-  val[2] = (int16_t)buff[5];
-  val[2] = (val[2] * 256) + (int16_t)buff[4];
+  /* SW_RESET o BOOT riportano i registri ai valori di default: la copia non vale piu' */
+  if ((first <= LSM6DSO16IS_CTRL3_C) && (last >= LSM6DSO16IS_CTRL3_C) &&
+      ((value[LSM6DSO16IS_CTRL3_C - first] & 0x81U) != 0U)) {
+    config_shadow_valid = 0;
+    return;
+  }
 
-  return ret;
+  for (uint16_t r = first; r <= last; r++) {
+    if ((r >= LSM6DSO16IS_CONFIG_FIRST_REG) && (r <= LSM6DSO16IS_CONFIG_LAST_REG)) {
+      config_shadow.reg[r - LSM6DSO16IS_CONFIG_FIRST_REG] = value[r - first];
+    }
+  }
 }
 
-int32_t LSM6DSO16IS::ia_ispu_get(uint32_t *val)
+int32_t LSM6DSO16IS::config_shadow_load(void)
 {
-  uint8_t buff[4];
   int32_t ret;
 
-  ret = readRegister(LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE, &buff[0], 4);
-
-  *val = (uint32_t)buff[3];
-  *val = (*val * 256U) + (uint32_t)buff[2];
-  *val = (*val * 256U) + (uint32_t)buff[1];
-  *val = (*val * 256U) + (uint32_t)buff[0];
+  ret = readRegister(LSM6DSO16IS_CONFIG_FIRST_REG, config_shadow.reg, sizeof(config_shadow.reg));
+  config_shadow_valid = (ret == 0) ? 1U : 0U;
 
   return ret;
 }
 
-int32_t LSM6DSO16IS::mem_bank_set(lsm6dso16is_mem_bank_t val)
+int32_t LSM6DSO16IS::config_diff_write(const LSM6DSO16IS_Config_Image_t *image, uint8_t first, uint8_t last)
 {
-  lsm6dso16is_func_cfg_access_t func_cfg_access;
-  int32_t ret;
+  uint8_t reg = first;
+  int32_t ret = 0;
 
-  ret = readRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+  while ((reg <= last) && (ret == 0)) {
+    uint8_t start;
 
-  if (ret == 0) {
-    func_cfg_access.shub_reg_access = (val == LSM6DSO16IS_SENSOR_HUB_MEM_BANK) ? 0x1U : 0x0U;
-    func_cfg_access.ispu_reg_access = (val == LSM6DSO16IS_ISPU_MEM_BANK) ? 0x1U : 0x0U;
-    ret = writeRegister(LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+    if (!config_reg_writable(reg) ||
+        (image->reg[reg - LSM6DSO16IS_CONFIG_FIRST_REG] == config_shadow.reg[reg - LSM6DSO16IS_CONFIG_FIRST_REG])) {
+      reg++;
+      continue;
+    }
+
+    start = reg;
+    while ((reg <= last) && config_reg_writable(reg) &&
+           (image->reg[reg - LSM6DSO16IS_CONFIG_FIRST_REG] != config_shadow.reg[reg - LSM6DSO16IS_CONFIG_FIRST_REG])) {
+      reg++;
+    }
+    ret = writeRegister(start, &image->reg[start - LSM6DSO16IS_CONFIG_FIRST_REG], (uint16_t)(reg - start));
   }
 
   return ret;
-}
\ No newline at end of file
+}
@@ -27,17 +27,118 @@ SOFTWARE.
 #ifndef LSM6DSO16IS_H
 #define LSM6DSO16IS_H
 
-#include "mbed.h"
+#include "LSM6DSO16IS_Platform.h"
 #include <cstdint>
 #include "registers.h"
+#include "LSM6DSO16IS_Tables.h"
+#include "LSM6DSO16IS_Bus.h"
+#include "LSM6DSO16IS_Histogram.h"
 
+#define LSM6DSO16IS_ISPU_BOOT_FLAG              (1UL << 0)
+#define LSM6DSO16IS_ISPU_BOOT_BACKOFF_MIN_US    100U
+#define LSM6DSO16IS_ISPU_BOOT_BACKOFF_MAX_US    8000U
+#define LSM6DSO16IS_ISPU_MAILBOX_BACKOFF_MIN_US 10U
+#define LSM6DSO16IS_ISPU_MAILBOX_BACKOFF_MAX_US 500U
+#define LSM6DSO16IS_ISPU_MEM_CHUNK              64U
+#define LSM6DSO16IS_CONFIG_FIRST_REG            LSM6DSO16IS_DRDY_PULSED_REG
+#define LSM6DSO16IS_CONFIG_LAST_REG             LSM6DSO16IS_CTRL10_C
+#define LSM6DSO16IS_CONFIG_RESERVED_0           0x0CU
+#define LSM6DSO16IS_CONFIG_RESERVED_1           0x17U
+#ifndef LSM6DSO16IS_MAX_WRITE_LEN
+#define LSM6DSO16IS_MAX_WRITE_LEN               64U
+#endif
+#define LSM6DSO16IS_TIMESTAMP_LSB_NS            25000U
+#define LSM6DSO16IS_G_WAKE_POLL_US              100U
+#define LSM6DSO16IS_G_WAKE_TIMEOUT_US           200000U
+#define LSM6DSO16IS_G_SLEEP_MAX_IDLE_MS         500U
+#define LSM6DSO16IS_ST_SETTLE_US                100000U
+#define LSM6DSO16IS_ST_SAMPLE_TIMEOUT_US        50000U
+#define LSM6DSO16IS_XL_ST_MIN_MG                50
+#define LSM6DSO16IS_XL_ST_MAX_MG                1700
+#define LSM6DSO16IS_G_ST_MIN_MDPS               150000
+#define LSM6DSO16IS_G_ST_MAX_MDPS               700000
+
+#define LSM6DSO16IS_ISPU_BOOT_TIMEOUT_MS        100U
+
+#define LSM6DSO16IS_SPI_FREQUENCY               10000000
+#define LSM6DSO16IS_SPI_READ                    0x80U
+/* One DMA sample: command byte, then OUTX_L_G .. OUTZ_H_A (gyroscope, accelerometer) */
+#define LSM6DSO16IS_DMA_SAMPLE_SIZE             13U
+#define LSM6DSO16IS_DMA_BUF_SIZE(samples)       ((samples) * LSM6DSO16IS_DMA_SAMPLE_SIZE)
+#ifndef LSM6DSO16IS_DMA_PAUSE_TIMEOUT_US
+#define LSM6DSO16IS_DMA_PAUSE_TIMEOUT_US        1000U
+#endif
+
+#if defined(LSM6DSO16IS_BUS_STATS) || defined(LSM6DSO16IS_LATENCY_HIST)
+#define LSM6DSO16IS_BUS_TIMING
+#endif
+
+static_assert(LSM6DSO16IS_ISPU_MEM_CHUNK <= LSM6DSO16IS_MAX_WRITE_LEN,
+              "ISPU memory is written in chunks of LSM6DSO16IS_ISPU_MEM_CHUNK bytes");
+
+typedef enum {
+  LSM6DSO16IS_ISPU_DATA_RAM =             0x0,
+  LSM6DSO16IS_ISPU_PROGRAM_RAM =          0x1,
+} lsm6dso16is_ispu_mem_sel_val_t;
+
+/* One section of an ISPU image, see Load_ISPU_Image() */
+typedef struct {
+  lsm6dso16is_ispu_mem_sel_val_t mem_sel;
+  uint16_t address;
+  const uint8_t *data;
+  uint32_t len;
+} LSM6DSO16IS_ISPU_Section_t;
+
+/* Public calls the bus traffic is attributed to with LSM6DSO16IS_BUS_STATS */
+typedef enum {
+  LSM6DSO16IS_API_OTHER = 0,
+  LSM6DSO16IS_API_BEGIN,
+  LSM6DSO16IS_API_CONFIG,
+  LSM6DSO16IS_API_ENABLE_X,
+  LSM6DSO16IS_API_DISABLE_X,
+  LSM6DSO16IS_API_SET_X_ODR,
+  LSM6DSO16IS_API_SET_X_FS,
+  LSM6DSO16IS_API_GET_X_AXES,
+  LSM6DSO16IS_API_ENABLE_G,
+  LSM6DSO16IS_API_DISABLE_G,
+  LSM6DSO16IS_API_SET_G_ODR,
+  LSM6DSO16IS_API_SET_G_FS,
+  LSM6DSO16IS_API_GET_G_AXES,
+  LSM6DSO16IS_API_READ_REG,
+  LSM6DSO16IS_API_WRITE_REG,
+  LSM6DSO16IS_API_GET_ISPU_STATUS,
+  LSM6DSO16IS_API_READ_ISPU_OUTPUT,
+  LSM6DSO16IS_API_ISPU_MAILBOX,
+  LSM6DSO16IS_API_ISPU_IMAGE,
+  LSM6DSO16IS_API_COUNT
+} LSM6DSO16IS_Bus_Api_t;
+
+/* Bus cost of one public call, accumulated over all its invocations */
+typedef struct {
+  uint32_t calls;
+  uint32_t transactions;
+  uint32_t bytes;
+  uint64_t cycles;
+  uint64_t time_us;
+} LSM6DSO16IS_Bus_Stats_t;
+
+/* Sample path latencies recorded with LSM6DSO16IS_LATENCY_HIST */
+typedef enum {
+  LSM6DSO16IS_LATENCY_DRDY_TO_READ = 0,
+  LSM6DSO16IS_LATENCY_BUS_TRANSFER,
+  LSM6DSO16IS_LATENCY_CONVERSION,
+  LSM6DSO16IS_LATENCY_COUNT
+} LSM6DSO16IS_Latency_t;
 
 
 class LSM6DSO16IS {
 public:
     // Costruttori privati
+#ifndef LSM6DSO16IS_HOST_BUILD
     LSM6DSO16IS(PinName sda, PinName scl);
     LSM6DSO16IS(PinName mosi, PinName miso, PinName sck, PinName cs);
+#endif
+    LSM6DSO16IS(LSM6DSO16IS_Bus *bus);
 
     // Distruttore privato
     ~LSM6DSO16IS();
@@ -50,11 +151,18 @@ public:
     void initialize();
     void readSensorData();
     LSM6DSO16ISStatusTypeDef begin(void);
+    LSM6DSO16ISStatusTypeDef Begin_Warm(const LSM6DSO16IS_Config_t *Config, uint8_t *Adopted);
+    LSM6DSO16ISStatusTypeDef Set_Config(const LSM6DSO16IS_Config_t *Config);
+    LSM6DSO16ISStatusTypeDef Apply_Config(const LSM6DSO16IS_Config_t *Config);
+    static void Get_Default_Config(LSM6DSO16IS_Config_t *Config);
+    static void Build_Config_Image(const LSM6DSO16IS_Config_t *Config, LSM6DSO16IS_Config_Image_t *Image);
+    static void Get_Config_Mask(LSM6DSO16IS_Config_Image_t *Mask);
     LSM6DSO16ISStatusTypeDef ReadID(uint8_t *Id);
     LSM6DSO16ISStatusTypeDef Enable_X(void);
     LSM6DSO16ISStatusTypeDef Disable_X(void);
     LSM6DSO16ISStatusTypeDef Get_X_ODR(float_t *Odr);
     LSM6DSO16ISStatusTypeDef Set_X_ODR(float_t Odr);
+    LSM6DSO16ISStatusTypeDef Set_X_ODR(lsm6dso16is_xl_data_rate_t Code);
     LSM6DSO16ISStatusTypeDef Get_X_FS(int32_t *FullScale);
     LSM6DSO16ISStatusTypeDef Set_X_FS(int32_t FullScale);
     LSM6DSO16ISStatusTypeDef Get_X_Sensitivity(float_t *Sensitivity);
@@ -65,28 +173,93 @@ public:
     LSM6DSO16ISStatusTypeDef Get_G_Sensitivity(float_t *Sensitivity);
     LSM6DSO16ISStatusTypeDef Get_G_ODR(float_t *Odr);
     LSM6DSO16ISStatusTypeDef Set_G_ODR(float_t Odr);
+    LSM6DSO16ISStatusTypeDef Set_G_ODR(lsm6dso16is_gy_data_rate_t Code);
     LSM6DSO16ISStatusTypeDef Get_G_FS(int32_t  *FullScale);
     LSM6DSO16ISStatusTypeDef Set_G_FS(int32_t FullScale);
     LSM6DSO16ISStatusTypeDef Get_G_AxesRaw(int32_t *Value);
     LSM6DSO16ISStatusTypeDef Get_G_Axes(float *AngularRate);
     LSM6DSO16ISStatusTypeDef Read_Reg(uint8_t Reg, uint8_t *Data);
+    LSM6DSO16ISStatusTypeDef Read_Reg(uint8_t Reg, uint8_t *Data, uint16_t Len);
+    LSM6DSO16ISStatusTypeDef Read_Reg_Groups(const LSM6DSO16IS_Read_Group_t *Groups, uint8_t Count);
     LSM6DSO16ISStatusTypeDef Get_ISPU_Status(LSM6DSO16IS_ISPU_Status_t *Status);
     LSM6DSO16ISStatusTypeDef Read_ISPU_Output(uint8_t Reg, uint8_t *Data, uint8_t len);
     LSM6DSO16ISStatusTypeDef Write_Reg(uint8_t Reg, uint8_t Data);
+    LSM6DSO16ISStatusTypeDef Write_Reg(uint8_t Reg, const uint8_t *Data, uint16_t Len);
+    LSM6DSO16ISStatusTypeDef Write_Reg_List(const LSM6DSO16IS_Reg_Write_t *List, uint16_t Count);
     LSM6DSO16ISStatusTypeDef Set_X_SelfTest(uint8_t Val);
     LSM6DSO16ISStatusTypeDef Get_X_DRDY_Status(uint8_t *Status);
     LSM6DSO16ISStatusTypeDef Get_X_Init_Status(uint8_t *Status);
     LSM6DSO16ISStatusTypeDef Set_X_INT1_DRDY(uint8_t Val);
     LSM6DSO16ISStatusTypeDef Set_G_SelfTest(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Run_X_SelfTest(uint8_t Samples, LSM6DSO16IS_SelfTest_Report_t *Report);
+    LSM6DSO16ISStatusTypeDef Run_G_SelfTest(uint8_t Samples, LSM6DSO16IS_SelfTest_Report_t *Report);
     LSM6DSO16ISStatusTypeDef Get_G_DRDY_Status(uint8_t *Status);
     LSM6DSO16ISStatusTypeDef Get_G_Init_Status(uint8_t *Status);
     LSM6DSO16ISStatusTypeDef Set_G_INT1_DRDY(uint8_t Val);
     LSM6DSO16ISStatusTypeDef Set_DRDY_Mode(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Set_X_INT2_DRDY(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Set_G_INT2_DRDY(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Set_T_INT2_DRDY(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Set_INT2_On_INT1(uint8_t Val);
     LSM6DSO16ISStatusTypeDef Set_X_ODR_When_Enabled(float_t Odr);
     LSM6DSO16ISStatusTypeDef Set_X_ODR_When_Disabled(float_t Odr);
     LSM6DSO16ISStatusTypeDef Set_G_ODR_When_Enabled(float_t Odr);
     LSM6DSO16ISStatusTypeDef Set_G_ODR_When_Disabled(float_t Odr);
+    LSM6DSO16ISStatusTypeDef Set_X_ODR_With_Mode(float_t Odr, LSM6DSO16IS_Operating_Mode_t Mode);
+    LSM6DSO16ISStatusTypeDef Set_G_ODR_With_Mode(float_t Odr, LSM6DSO16IS_Operating_Mode_t Mode);
+    LSM6DSO16ISStatusTypeDef Sleep_G(void);
+    LSM6DSO16ISStatusTypeDef Standby_G(uint32_t Expected_Idle_ms);
+    LSM6DSO16ISStatusTypeDef Wake_G(uint32_t Timeout_us = LSM6DSO16IS_G_WAKE_TIMEOUT_US);
+    LSM6DSO16ISStatusTypeDef Get_G_Standby(LSM6DSO16IS_G_Standby_t *State);
+    LSM6DSO16ISStatusTypeDef Get_G_Wake_Latency(uint32_t *Latency_us);
+    LSM6DSO16ISStatusTypeDef Set_G_Sleep_Max_Idle(uint32_t Idle_ms);
+    LSM6DSO16ISStatusTypeDef Reset_ISPU(void);
+    LSM6DSO16ISStatusTypeDef Set_ISPU_Clock(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Set_ISPU_Int_Latched(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Start_ISPU(void);
+    LSM6DSO16ISStatusTypeDef Wait_ISPU_Boot(uint32_t Timeout_ms);
+    LSM6DSO16ISStatusTypeDef Get_ISPU_Boot_Status(uint8_t *Status);
+    LSM6DSO16ISStatusTypeDef Get_ISPU_Boot_Time(uint32_t *Time_us);
+    LSM6DSO16ISStatusTypeDef Set_Timestamp(uint8_t Val);
+    LSM6DSO16ISStatusTypeDef Get_Timestamp(uint32_t *Ticks);
+#ifndef LSM6DSO16IS_HOST_BUILD
+    LSM6DSO16ISStatusTypeDef Set_INT1_Pin(PinName Int1);
+    LSM6DSO16ISStatusTypeDef Set_INT2_Pin(PinName Int2);
+    LSM6DSO16ISStatusTypeDef Enable_DRDY_Capture(EventQueue *Queue, Callback<void(uint32_t)> Handler);
+    LSM6DSO16ISStatusTypeDef Enable_DRDY_Capture(LSM6DSO16IS_SensorIntPin_t Pin, EventQueue *Queue,
+                                                 Callback<void(uint32_t)> Handler);
+    LSM6DSO16ISStatusTypeDef Get_DRDY_Capture_Stats(uint32_t *Captured, uint32_t *Dropped);
+    LSM6DSO16ISStatusTypeDef Get_DRDY_Capture_Stats(LSM6DSO16IS_SensorIntPin_t Pin, uint32_t *Captured,
+                                                    uint32_t *Dropped);
+#if DEVICE_SPI_ASYNCH
+    LSM6DSO16ISStatusTypeDef Start_DMA_Capture(LSM6DSO16IS_SensorIntPin_t Pin, uint8_t *Buf0, uint8_t *Buf1,
+                                               uint16_t Samples, EventQueue *Queue,
+                                               Callback<void(const uint8_t *, uint16_t)> Handler);
+    LSM6DSO16ISStatusTypeDef Stop_DMA_Capture(void);
+    LSM6DSO16ISStatusTypeDef Get_DMA_Capture_Stats(uint32_t *Blocks, uint32_t *Overruns);
+    static void Get_DMA_Sample(const uint8_t *Block, uint16_t Index, int16_t *Gyro, int16_t *Accel);
+#endif
+#endif
+    LSM6DSO16ISStatusTypeDef Write_ISPU_Mailbox(const uint16_t *Words, uint8_t Count, uint16_t If2s_Flags);
+    LSM6DSO16ISStatusTypeDef Get_ISPU_Mailbox_Flags(uint16_t *If2s_Flags, uint16_t *S2if_Flags);
+    LSM6DSO16ISStatusTypeDef Send_ISPU_Mailbox(const uint16_t *Words, uint8_t Count, uint16_t If2s_Flags,
+                                               uint16_t Ack_Mask, uint32_t Timeout_us, uint16_t *S2if_Flags);
+    LSM6DSO16ISStatusTypeDef Load_ISPU_Image(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count);
+    LSM6DSO16ISStatusTypeDef Get_ISPU_Image_CRC(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count, uint32_t *Crc);
+    LSM6DSO16ISStatusTypeDef Boot_ISPU_Image(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count,
+                                             uint8_t Force, uint8_t *Reloaded);
+    static uint32_t ISPU_Image_CRC(const LSM6DSO16IS_ISPU_Section_t *Sections, uint8_t Count);
     bool isConnected();    
+    void Lock(void);
+    void Unlock(void);
+    LSM6DSO16ISStatusTypeDef Get_Bus_Stats(LSM6DSO16IS_Bus_Api_t Api, LSM6DSO16IS_Bus_Stats_t *Stats);
+    LSM6DSO16ISStatusTypeDef Reset_Bus_Stats(void);
+    LSM6DSO16ISStatusTypeDef Get_Latency_Histogram(LSM6DSO16IS_Latency_t Which,
+                                                   LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Reset);
+    LSM6DSO16ISStatusTypeDef Get_Latency_Summary(LSM6DSO16IS_Latency_t Which, LSM6DSO16IS_Latency_Summary_t *Summary,
+                                                 uint8_t Reset);
+    LSM6DSO16ISStatusTypeDef Reset_Latency_Histograms(void);
+    void Notify_DRDY(void);
     
     void set_SDO_SAO_TO_GND();
     void set_SDO_SAO_TO_VCC();
@@ -94,9 +267,47 @@ public:
 
 private:
     // Variabili membro private per la gestione del sensore
+    LSM6DSO16IS_Bus* bus;
+#ifndef LSM6DSO16IS_HOST_BUILD
     I2C* i2c;
     SPI* spi;
     DigitalOut* cs_pin;
+    InterruptIn* int1_pin;
+    InterruptIn* int2_pin;
+
+    // Eventi di boot ISPU segnalati su INT1, se instradati da Start_ISPU()
+    EventFlags ispu_boot_flags;
+    uint8_t ispu_boot_irq;
+
+    // Cattura dei fronti di data-ready, un gestore per ciascun pin (INT1, INT2)
+    EventQueue* drdy_queue[2];
+    Callback<void(uint32_t)> drdy_handler[2];
+    volatile uint32_t drdy_captured[2];
+    volatile uint32_t drdy_dropped[2];
+
+#if DEVICE_SPI_ASYNCH
+    // Cattura DMA su SPI: due buffer alternati di dma_samples campioni
+    uint8_t dma_tx[LSM6DSO16IS_DMA_SAMPLE_SIZE];
+    uint8_t *dma_buf[2];
+    uint16_t dma_samples;
+    volatile uint16_t dma_index;
+    volatile uint8_t dma_fill;
+    volatile uint8_t dma_active;
+    volatile uint8_t dma_busy;
+    volatile uint8_t dma_pending[2];
+    LSM6DSO16IS_SensorIntPin_t dma_pin;
+    EventQueue *dma_queue;
+    Callback<void(const uint8_t *, uint16_t)> dma_handler;
+    volatile uint32_t dma_blocks;
+    volatile uint32_t dma_overruns;
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    uint32_t dma_start;
+#endif
+#endif
+#endif
+    uint32_t ispu_boot_start_us;
+    uint32_t ispu_boot_time_us;
+    uint8_t ispu_boot_pending;
 
     #ifdef IKS4A1
         uint8_t lsm6ds01tis_8bit_address = (0x6A << 1); // 8 bits device address
@@ -106,10 +317,44 @@ private:
 
     float X_Last_ODR;
     float G_Last_ODR;
+    LSM6DSO16IS_Operating_Mode_t X_Last_Mode;
+    LSM6DSO16IS_Operating_Mode_t G_Last_Mode;
     uint8_t X_isEnabled;
     uint8_t G_isEnabled;
+    LSM6DSO16IS_G_Standby_t G_Standby;
+    uint32_t G_Wake_Latency_us;
+    uint32_t G_Sleep_Max_Idle_ms;
     uint8_t isInitialized;
 
+    // Copia dei registri di controllo scritti dall'ultima configurazione
+    LSM6DSO16IS_Config_Image_t config_shadow;
+    uint8_t config_shadow_valid;
+    uint8_t main_bank_selected;
+    // Ritorno al banco principale fallito: il banco selezionato non e' noto
+    uint8_t bank_fault;
+
+#ifdef LSM6DSO16IS_THREAD_SAFE
+    // Mutex del bus, tenuto anche per tutta la durata di un cambio di banco
+    lsm6dso16is_mutex_t bus_mutex;
+    uint8_t bank_lock_held;
+#endif
+
+#ifdef LSM6DSO16IS_BUS_STATS
+    // Costo sul bus di ciascuna API pubblica e API attualmente in corso
+    friend class LSM6DSO16IS_Bus_Scope;
+    LSM6DSO16IS_Bus_Stats_t bus_stats[LSM6DSO16IS_API_COUNT];
+    LSM6DSO16IS_Bus_Api_t bus_api;
+#endif
+#ifdef LSM6DSO16IS_LATENCY_HIST
+    // Istogrammi di latenza e istante dell'ultimo data-ready non ancora letto (0: nessuno)
+    LSM6DSO16IS_Histogram latency[LSM6DSO16IS_LATENCY_COUNT];
+    std::atomic<uint32_t> drdy_edge;
+    void drdy_read_start(uint8_t reg);
+#endif
+#ifdef LSM6DSO16IS_BUS_TIMING
+    void bus_account(uint16_t transactions, uint32_t bytes, uint32_t start);
+#endif
+
     float_t from_fs2g_to_mg(int16_t lsb);
     float_t from_fs4g_to_mg(int16_t lsb);
     float_t from_fs8g_to_mg(int16_t lsb);
@@ -123,6 +368,9 @@ private:
 
     bool readRegister(uint8_t reg, uint8_t *value, uint16_t len);
     bool writeRegister(uint8_t reg, const uint8_t *value, uint16_t len);
+    bool readBus(uint8_t reg, uint8_t *value, uint16_t len);
+    bool writeBus(uint8_t reg, const uint8_t *value, uint16_t len);
+    void config_shadow_track(uint8_t reg, const uint8_t *value, uint16_t len, bool failed);
 
     int32_t xl_data_rate_set(lsm6dso16is_xl_data_rate_t val);
     int32_t xl_hm_mode_set(lsm6dso16is_hm_mode_t val);
@@ -141,6 +389,129 @@ private:
     int32_t angular_rate_raw_get(int16_t *val);
     int32_t ia_ispu_get(uint32_t *val);
     int32_t mem_bank_set(lsm6dso16is_mem_bank_t val);
+    int32_t main_bank_ensure(void);
+    int32_t bank_fault_recover(void);
+    static bool config_reg_writable(uint8_t reg);
+    void config_image_merge(LSM6DSO16IS_Config_Image_t *image);
+    int32_t config_image_write(const LSM6DSO16IS_Config_Image_t *image, uint8_t first, uint8_t last);
+    void config_adopt(const LSM6DSO16IS_Config_t *config, const LSM6DSO16IS_Config_Image_t *image);
+    int32_t config_shadow_load(void);
+    int32_t config_diff_write(const LSM6DSO16IS_Config_Image_t *image, uint8_t first, uint8_t last);
+    int32_t ispu_boot_end_get(uint8_t *val);
+    int32_t int1_boot_set(uint8_t val);
+    int32_t pin_int1_route_get(lsm6dso16is_pin_int1_route_t *val);
+    int32_t pin_int1_route_set(lsm6dso16is_pin_int1_route_t val);
+    int32_t data_ready_mode_set(lsm6dso16is_data_ready_mode_t val);
+    int32_t pin_int2_route_get(lsm6dso16is_pin_int2_route_t *val);
+    int32_t pin_int2_route_set(lsm6dso16is_pin_int2_route_t val);
+    int32_t int2_on_int1_set(uint8_t val);
+    int32_t timestamp_set(uint8_t val);
+    int32_t timestamp_raw_get(uint32_t *val);
+    int32_t gy_sleep_mode_set(uint8_t val);
+    int32_t status_reg_get(lsm6dso16is_status_reg_t *val);
+    int32_t xl_self_test_set(lsm6dso16is_xl_self_test_t val);
+    int32_t gy_self_test_set(lsm6dso16is_gy_self_test_t val);
+    int32_t self_test_sum(uint8_t xl, uint8_t samples, int32_t *sum);
+    LSM6DSO16ISStatusTypeDef self_test_run(uint8_t xl, uint8_t samples, LSM6DSO16IS_SelfTest_Report_t *report);
+#ifndef LSM6DSO16IS_HOST_BUILD
+    void int1_isr(void);
+    void int2_isr(void);
+    void drdy_post(LSM6DSO16IS_SensorIntPin_t pin, uint32_t timestamp);
+    InterruptIn* int_pin_get(LSM6DSO16IS_SensorIntPin_t pin);
+    bool dma_on_int1(void);
+    int32_t dma_pause(InterruptIn **pin);
+    void dma_resume(InterruptIn *pin);
+#if DEVICE_SPI_ASYNCH
+    void dma_trigger(void);
+    void dma_done(int event);
+    void dma_block(uint8_t index);
+#endif
+#endif
+    int32_t mailbox_words_write(const uint16_t *words, uint8_t count);
+    int32_t mailbox_if2s_write(uint16_t val);
+    int32_t mailbox_flags_get(uint16_t *if2s, uint16_t *s2if);
+    void backoff_wait(uint32_t *backoff_us, uint32_t max_us);
+    int32_t ispu_mem_select(lsm6dso16is_ispu_mem_sel_val_t mem_sel, uint8_t read_en, uint16_t addr);
+    static uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t len);
 };
 
+/*
+ * Holds the driver lock for the lifetime of the object, to group several
+ * driver calls into one atomic sequence. A no-op unless LSM6DSO16IS_THREAD_SAFE
+ * is defined.
+ */
+class LSM6DSO16IS_Lock_Guard {
+public:
+    explicit LSM6DSO16IS_Lock_Guard(LSM6DSO16IS &dev) : dev(dev)
+    {
+        dev.Lock();
+    }
+    ~LSM6DSO16IS_Lock_Guard()
+    {
+        dev.Unlock();
+    }
+
+private:
+    LSM6DSO16IS &dev;
+
+    LSM6DSO16IS_Lock_Guard(const LSM6DSO16IS_Lock_Guard &);
+    LSM6DSO16IS_Lock_Guard &operator=(const LSM6DSO16IS_Lock_Guard &);
+};
+
+#ifdef LSM6DSO16IS_BUS_STATS
+/*
+ * Attributes the bus traffic of a public call to its LSM6DSO16IS_Bus_Api_t.
+ * Only the outermost scope counts, so the registers touched by nested public
+ * calls are charged to the call the application made. The scope holds the
+ * bus lock, so with LSM6DSO16IS_THREAD_SAFE no other thread can change or be
+ * charged to the call in progress; Release() and Acquire() hand the bus over
+ * around a wait.
+ */
+class LSM6DSO16IS_Bus_Scope {
+public:
+    LSM6DSO16IS_Bus_Scope(LSM6DSO16IS &dev, LSM6DSO16IS_Bus_Api_t api) : dev(dev), api(api)
+    {
+        dev.Lock();
+        prev = dev.bus_api;
+        if (prev == LSM6DSO16IS_API_OTHER) {
+            dev.bus_api = api;
+            dev.bus_stats[api].calls++;
+        }
+    }
+    ~LSM6DSO16IS_Bus_Scope()
+    {
+        dev.bus_api = prev;
+        dev.Unlock();
+    }
+    void Release(void)
+    {
+        dev.bus_api = prev;
+        dev.Unlock();
+    }
+    void Acquire(void)
+    {
+        dev.Lock();
+        if (prev == LSM6DSO16IS_API_OTHER) {
+            dev.bus_api = api;
+        }
+    }
+
+private:
+    LSM6DSO16IS &dev;
+    LSM6DSO16IS_Bus_Api_t api;
+    LSM6DSO16IS_Bus_Api_t prev;
+
+    LSM6DSO16IS_Bus_Scope(const LSM6DSO16IS_Bus_Scope &);
+    LSM6DSO16IS_Bus_Scope &operator=(const LSM6DSO16IS_Bus_Scope &);
+};
+
+#define LSM6DSO16IS_BUS_SCOPE(api) LSM6DSO16IS_Bus_Scope bus_scope(*this, api)
+#define LSM6DSO16IS_BUS_SCOPE_RELEASE() bus_scope.Release()
+#define LSM6DSO16IS_BUS_SCOPE_ACQUIRE() bus_scope.Acquire()
+#else
+#define LSM6DSO16IS_BUS_SCOPE(api) do { } while (0)
+#define LSM6DSO16IS_BUS_SCOPE_RELEASE() do { } while (0)
+#define LSM6DSO16IS_BUS_SCOPE_ACQUIRE() do { } while (0)
+#endif
+
 #endif // LSM6DSO16IS_H
\ No newline at end of file
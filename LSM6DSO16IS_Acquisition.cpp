@@ -0,0 +1,276 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Acquisition.h"
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+
+LSM6DSO16IS_Acquisition::LSM6DSO16IS_Acquisition(LSM6DSO16IS *sensor, osPriority priority, uint32_t stack_size)
+    : thread(priority, stack_size), queue(LSM6DSO16IS_ACQ_QUEUE_EVENTS * LSM6DSO16IS_ACQ_EVENT_SIZE)
+{
+    this->sensor = sensor;
+    running = 0;
+    use_drdy = 0;
+    drdy_pin = LSM6DSO16IS_INT1_PIN;
+    period_us = 0;
+    acc_sensitivity = 0.0f;
+    gyro_sensitivity = 0.0f;
+    subscribers = 0;
+    for (uint8_t i = 0; i < LSM6DSO16IS_ACQ_MAX_SUBSCRIBERS; i++) {
+        sub_queue[i] = NULL;
+    }
+    Reset_Stats();
+
+    thread.start(callback(&queue, &EventQueue::dispatch_forever));
+}
+
+LSM6DSO16IS_Acquisition::~LSM6DSO16IS_Acquisition()
+{
+    Stop();
+    queue.break_dispatch();
+    thread.join();
+}
+
+/**
+  * @brief  Add a subscriber
+  * @note   Samples are posted by value to Queue, which runs Handler in its own
+  *         thread; a sample that does not fit in a full queue is dropped
+  * @param  Queue the subscriber event queue
+  * @param  Handler the function called with each sample
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Acquisition::Subscribe(EventQueue *Queue,
+                                                            Callback<void(LSM6DSO16IS_Acquisition_Sample_t)> Handler)
+{
+    if ((Queue == NULL) || running || (subscribers >= LSM6DSO16IS_ACQ_MAX_SUBSCRIBERS)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    sub_queue[subscribers] = Queue;
+    sub_handler[subscribers] = Handler;
+    subscribers++;
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Start the acquisition on the data-ready edges of an interrupt pin
+  * @note   The expected period comes from the accelerometer output data rate,
+  *         or from the gyroscope one when the accelerometer is off
+  * @param  Pin the interrupt pin carrying the data-ready signal
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Acquisition::Start_DRDY(LSM6DSO16IS_SensorIntPin_t Pin)
+{
+    float_t odr = 0.0f;
+
+    if (running) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    if ((sensor->Get_X_ODR(&odr) != LSM6DSO16IS_STATUS_OK) || (odr <= 0.0f)) {
+        if ((sensor->Get_G_ODR(&odr) != LSM6DSO16IS_STATUS_OK) || (odr <= 0.0f)) {
+            return LSM6DSO16IS_STATUS_ERROR;
+        }
+    }
+
+    if (prepare((uint32_t)(1000000.0f / odr)) != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    if (sensor->Enable_DRDY_Capture(Pin, &queue, callback(this, &LSM6DSO16IS_Acquisition::service))
+        != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    use_drdy = 1;
+    drdy_pin = Pin;
+    running = 1;
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Start the acquisition on a periodic ticker
+  * @param  Period_us the sampling period in microseconds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Acquisition::Start_Ticker(uint32_t Period_us)
+{
+    if (running || (Period_us == 0U)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    if (prepare(Period_us) != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    use_drdy = 0;
+    running = 1;
+    ticker.attach(callback(this, &LSM6DSO16IS_Acquisition::tick_isr), std::chrono::microseconds(Period_us));
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Stop the acquisition
+  * @note   Triggers already queued are still serviced
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Acquisition::Stop(void)
+{
+    LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+
+    if (!running) {
+        return LSM6DSO16IS_STATUS_OK;
+    }
+
+    if (use_drdy) {
+        if (sensor->Enable_DRDY_Capture(drdy_pin, NULL, Callback<void(uint32_t)>()) != LSM6DSO16IS_STATUS_OK) {
+            ret = LSM6DSO16IS_STATUS_ERROR;
+        }
+    } else {
+        ticker.detach();
+    }
+    running = 0;
+
+    return ret;
+}
+
+/**
+  * @brief  Get the acquisition statistics
+  * @param  Stats pointer where the statistics are written
+  */
+void LSM6DSO16IS_Acquisition::Get_Stats(LSM6DSO16IS_Acquisition_Stats_t *Stats)
+{
+    uint32_t elapsed_us;
+
+    stats_mutex.lock();
+    elapsed_us = last_us - start_us;
+    Stats->samples = samples;
+    Stats->missed = missed;
+    Stats->max_latency_us = max_latency_us;
+    Stats->errors = errors;
+    Stats->dropped = dropped;
+    stats_mutex.unlock();
+
+    Stats->rate_hz = ((Stats->samples > 1U) && (elapsed_us != 0U))
+                     ? ((float_t)(Stats->samples - 1U) * 1000000.0f) / (float_t)elapsed_us : 0.0f;
+}
+
+/**
+  * @brief  Reset the acquisition statistics
+  * @note   Call it while the engine is stopped: Start_DRDY() and
+  *         Start_Ticker() reset them too
+  */
+void LSM6DSO16IS_Acquisition::Reset_Stats(void)
+{
+    stats_mutex.lock();
+    start_us = 0;
+    last_us = 0;
+    samples = 0;
+    missed = 0;
+    max_latency_us = 0;
+    errors = 0;
+    dropped = 0;
+    stats_mutex.unlock();
+}
+
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Acquisition::prepare(uint32_t period_us)
+{
+    if ((sensor->Get_X_Sensitivity(&acc_sensitivity) != LSM6DSO16IS_STATUS_OK) ||
+        (sensor->Get_G_Sensitivity(&gyro_sensitivity) != LSM6DSO16IS_STATUS_OK)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    this->period_us = period_us;
+    Reset_Stats();
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+void LSM6DSO16IS_Acquisition::tick_isr(void)
+{
+    /* Only timestamp here: the bus is accessed in the engine thread. A tick
+       lost because the queue is full shows up as a gap in service(). */
+    (void)queue.call(callback(this, &LSM6DSO16IS_Acquisition::service), lsm6dso16is_time_us());
+}
+
+void LSM6DSO16IS_Acquisition::service(uint32_t timestamp)
+{
+    LSM6DSO16IS_Acquisition_Sample_t sample;
+    uint8_t buff[12];
+    uint32_t latency_us;
+    uint32_t gap_us;
+    uint32_t drops = 0;
+
+    /* OUTX_L_G .. OUTZ_H_A: gyroscope then accelerometer in one burst. */
+    if (sensor->Read_Reg(LSM6DSO16IS_OUTX_L_G, buff, sizeof(buff)) != LSM6DSO16IS_STATUS_OK) {
+        stats_mutex.lock();
+        errors++;
+        stats_mutex.unlock();
+        return;
+    }
+
+    latency_us = lsm6dso16is_time_us() - timestamp;
+    stats_mutex.lock();
+    if (latency_us > max_latency_us) {
+        max_latency_us = latency_us;
+    }
+
+    if (samples == 0U) {
+        start_us = timestamp;
+    } else {
+        gap_us = timestamp - last_us;
+        if (gap_us > period_us + (period_us / 2U)) {
+            missed += ((gap_us + (period_us / 2U)) / period_us) - 1U;
+        }
+    }
+    last_us = timestamp;
+    samples++;
+    stats_mutex.unlock();
+
+    sample.timestamp_us = timestamp;
+    for (uint8_t i = 0; i < 3U; i++) {
+        sample.gyro_mdps[i] = (float_t)(int16_t)((uint16_t)buff[2U * i] | ((uint16_t)buff[(2U * i) + 1U] << 8))
+                              * gyro_sensitivity;
+        sample.acc_mg[i] = (float_t)(int16_t)((uint16_t)buff[6U + (2U * i)] | ((uint16_t)buff[7U + (2U * i)] << 8))
+                           * acc_sensitivity;
+    }
+
+    for (uint8_t i = 0; i < subscribers; i++) {
+        if (sub_queue[i]->call(sub_handler[i], sample) == 0) {
+            drops++;
+        }
+    }
+    if (drops != 0U) {
+        stats_mutex.lock();
+        dropped += drops;
+        stats_mutex.unlock();
+    }
+}
+
+#endif // LSM6DSO16IS_HOST_BUILD
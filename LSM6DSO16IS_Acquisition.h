@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_ACQUISITION_H
+#define LSM6DSO16IS_ACQUISITION_H
+
+#include "LSM6DSO16IS.h"
+
+#ifndef LSM6DSO16IS_HOST_BUILD
+
+#define LSM6DSO16IS_ACQ_MAX_SUBSCRIBERS    4U
+#define LSM6DSO16IS_ACQ_QUEUE_EVENTS       16U
+/* Each trigger is a call with its uint32_t timestamp bound to the callback */
+#define LSM6DSO16IS_ACQ_EVENT_SIZE         (EVENTS_EVENT_SIZE + sizeof(uint32_t))
+#ifndef LSM6DSO16IS_ACQ_STACK_SIZE
+#define LSM6DSO16IS_ACQ_STACK_SIZE         2048U
+#endif
+
+typedef struct {
+  uint32_t timestamp_us;
+  float_t acc_mg[3];
+  float_t gyro_mdps[3];
+} LSM6DSO16IS_Acquisition_Sample_t;
+
+typedef struct {
+  float_t rate_hz;
+  uint32_t samples;
+  uint32_t missed;
+  uint32_t max_latency_us;
+  uint32_t errors;
+  uint32_t dropped;
+} LSM6DSO16IS_Acquisition_Stats_t;
+
+/*
+ * Acquisition engine owned by the driver. A dedicated thread dispatches its own
+ * EventQueue; each trigger (a DRDY edge captured by the driver or a Ticker
+ * tick) is timestamped in interrupt context and serviced in that thread, which
+ * reads gyroscope and accelerometer outputs in one 12-byte burst, converts them
+ * and posts the sample to every subscriber queue.
+ *
+ * Statistics: rate_hz is the achieved sample rate since Start, missed counts
+ * the expected triggers that never got serviced, from the gaps longer than 1.5
+ * periods between serviced triggers (edges or ticks lost while the queue was
+ * full, or overwritten samples), max_latency_us is the worst time from
+ * the trigger to the end of the burst read, dropped counts the samples a full
+ * subscriber queue could not take.
+ *
+ * The statistics are updated by the engine thread under a mutex and Get_Stats()
+ * returns a consistent snapshot from any thread.
+ *
+ * The full scales are read at Start(): restart the engine after changing them.
+ * With DRDY triggering the data-ready routing (Set_X_INT1_DRDY(), ...) and the
+ * interrupt pin (Set_INT1_Pin()) are configured by the application.
+ */
+class LSM6DSO16IS_Acquisition {
+public:
+    LSM6DSO16IS_Acquisition(LSM6DSO16IS *sensor, osPriority priority = osPriorityHigh,
+                            uint32_t stack_size = LSM6DSO16IS_ACQ_STACK_SIZE);
+    ~LSM6DSO16IS_Acquisition();
+
+    LSM6DSO16ISStatusTypeDef Subscribe(EventQueue *Queue, Callback<void(LSM6DSO16IS_Acquisition_Sample_t)> Handler);
+    LSM6DSO16ISStatusTypeDef Start_DRDY(LSM6DSO16IS_SensorIntPin_t Pin);
+    LSM6DSO16ISStatusTypeDef Start_Ticker(uint32_t Period_us);
+    LSM6DSO16ISStatusTypeDef Stop(void);
+    void Get_Stats(LSM6DSO16IS_Acquisition_Stats_t *Stats);
+    void Reset_Stats(void);
+
+private:
+    LSM6DSO16ISStatusTypeDef prepare(uint32_t period_us);
+    void tick_isr(void);
+    void service(uint32_t timestamp);
+
+    LSM6DSO16IS *sensor;
+
+    // Thread ad alta priorita' che esegue la coda dell'engine
+    Thread thread;
+    EventQueue queue;
+    Ticker ticker;
+
+    // Sorgente del trigger
+    uint8_t running;
+    uint8_t use_drdy;
+    LSM6DSO16IS_SensorIntPin_t drdy_pin;
+    uint32_t period_us;
+
+    // Sensibilita' lette all'avvio
+    float_t acc_sensitivity;
+    float_t gyro_sensitivity;
+
+    // Sottoscrittori
+    uint8_t subscribers;
+    EventQueue *sub_queue[LSM6DSO16IS_ACQ_MAX_SUBSCRIBERS];
+    Callback<void(LSM6DSO16IS_Acquisition_Sample_t)> sub_handler[LSM6DSO16IS_ACQ_MAX_SUBSCRIBERS];
+
+    // Statistiche, protette da stats_mutex
+    Mutex stats_mutex;
+    uint32_t start_us;
+    uint32_t last_us;
+    uint32_t samples;
+    uint32_t missed;
+    uint32_t max_latency_us;
+    uint32_t errors;
+    uint32_t dropped;
+};
+
+#endif // LSM6DSO16IS_HOST_BUILD
+
+#endif // LSM6DSO16IS_ACQUISITION_H
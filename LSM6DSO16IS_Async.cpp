@@ -0,0 +1,463 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Async.h"
+
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__cpp_impl_coroutine)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+void LSM6DSO16IS_Async_Op::Complete(int32_t Status)
+{
+    status = Status;
+    loop->Schedule(waiter);
+}
+
+LSM6DSO16IS_Async_Bus_Adapter::LSM6DSO16IS_Async_Bus_Adapter(LSM6DSO16IS_Bus *bus)
+    : bus(bus), stop(false), in_flight(0)
+{
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    thread = std::thread(&LSM6DSO16IS_Async_Bus_Adapter::worker, this);
+}
+
+LSM6DSO16IS_Async_Bus_Adapter::~LSM6DSO16IS_Async_Bus_Adapter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    thread.join();
+    if (event_fd >= 0) {
+        close(event_fd);
+    }
+}
+
+int32_t LSM6DSO16IS_Async_Bus_Adapter::submit(LSM6DSO16IS_Async_Op *op)
+{
+    if (event_fd < 0) {
+        return 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(op);
+    }
+    wake.notify_one();
+    in_flight++;
+
+    return 0;
+}
+
+uint32_t LSM6DSO16IS_Async_Bus_Adapter::poll(void)
+{
+    std::deque<LSM6DSO16IS_Async_Op *> completed;
+    uint64_t count;
+
+    /* Clear the eventfd before taking the completions: one posted after the
+       swap leaves it readable for the next wait. */
+    if (::read(event_fd, &count, sizeof(count)) < 0) {
+        count = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.swap(done);
+    }
+
+    while (!completed.empty()) {
+        LSM6DSO16IS_Async_Op *op = completed.front();
+
+        completed.pop_front();
+        in_flight--;
+        op->Complete(op->status);
+    }
+
+    return in_flight;
+}
+
+void LSM6DSO16IS_Async_Bus_Adapter::worker(void)
+{
+    const uint64_t one = 1;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;) {
+        LSM6DSO16IS_Async_Op *op;
+
+        wake.wait(lock, [this] { return stop || !pending.empty(); });
+        if (stop) {
+            return;
+        }
+        op = pending.front();
+        pending.pop_front();
+
+        /* The blocking transfer runs without the lock: submit() never waits for it. */
+        lock.unlock();
+        op->status = (op->write != 0U) ? bus->write(op->reg, op->data, op->len)
+                     : bus->read(op->reg, op->data, op->len);
+        lock.lock();
+
+        done.push_back(op);
+        if (::write(event_fd, &one, sizeof(one)) < 0) {
+            /* Counter saturated: it is readable anyway. */
+        }
+    }
+}
+
+std::coroutine_handle<> LSM6DSO16IS_Task::promise_type::final_awaiter::await_suspend(
+    std::coroutine_handle<promise_type> h) noexcept
+{
+    promise_type &promise = h.promise();
+    std::coroutine_handle<> continuation = promise.continuation;
+
+    /* A spawned task has no owner: it frees itself. */
+    if (promise.detached != nullptr) {
+        promise.detached->running--;
+        h.destroy();
+    }
+
+    return continuation ? continuation : std::noop_coroutine();
+}
+
+/**
+  * @brief  Start a task in the background
+  * @param  Task the task, owned by the loop until it returns
+  */
+void LSM6DSO16IS_Async_Loop::Spawn(LSM6DSO16IS_Task Task)
+{
+    std::coroutine_handle<LSM6DSO16IS_Task::promise_type> h = Task.handle;
+
+    Task.handle = nullptr;
+    h.promise().detached = this;
+    running++;
+    Schedule(h);
+}
+
+/**
+  * @brief  Resume the ready coroutines and poll the transports once
+  * @retval true if there is still work to do
+  */
+bool LSM6DSO16IS_Async_Loop::Run_Once(void)
+{
+    std::deque<std::coroutine_handle<> > now;
+    uint32_t in_flight = 0;
+
+    now.swap(ready);
+    while (!now.empty()) {
+        now.front().resume();
+        now.pop_front();
+    }
+
+    for (size_t i = 0; i < buses.size(); i++) {
+        in_flight += buses[i]->poll();
+    }
+
+    return !ready.empty() || (in_flight != 0U);
+}
+
+/**
+  * @brief  Run until no coroutine can make progress
+  */
+void LSM6DSO16IS_Async_Loop::Run(void)
+{
+    while (Run_Once()) {
+        if (ready.empty()) {
+            wait();
+        }
+    }
+}
+
+void LSM6DSO16IS_Async_Loop::wait(void)
+{
+    std::vector<struct pollfd> fds(buses.size());
+
+    for (size_t i = 0; i < buses.size(); i++) {
+        fds[i].fd = buses[i]->fd();
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+        /* A transport without descriptor has to be polled again at once. */
+        if (fds[i].fd < 0) {
+            return;
+        }
+    }
+
+    (void)::poll(fds.data(), fds.size(), -1);
+}
+
+LSM6DSO16IS_Async::LSM6DSO16IS_Async(LSM6DSO16IS_Async_Bus *bus, LSM6DSO16IS_Async_Loop *loop)
+{
+    this->bus = bus;
+    this->loop = loop;
+    locked = 0;
+    acc_sensitivity = 0.0f;
+    gyro_sensitivity = 0.0f;
+}
+
+/**
+  * @brief  Read the full scales, used by Read_Frame() to convert the samples
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Init(void)
+{
+    uint8_t ctrl[2];
+    lsm6dso16is_ctrl2_g_t ctrl2_g;
+    lsm6dso16is_gy_full_scale_t gy_fs;
+
+    co_await lock();
+    /* CTRL1_XL and CTRL2_G in one burst. */
+    int32_t ret = co_await transfer(0, LSM6DSO16IS_CTRL1_XL, ctrl, 2);
+    unlock();
+
+    if (ret != 0) {
+        co_return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    *(uint8_t *)&ctrl2_g = ctrl[1];
+    gy_fs = (ctrl2_g.fs_125 != 0U) ? LSM6DSO16IS_125dps : (lsm6dso16is_gy_full_scale_t)ctrl2_g.fs_g;
+    acc_sensitivity = lsm6dso16is_xl_sensitivity[(ctrl[0] >> 2) & 0x3U];
+    gyro_sensitivity = lsm6dso16is_gy_sensitivity[lsm6dso16is_gy_fs_index(gy_fs)];
+
+    co_return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Read gyroscope and accelerometer outputs in one burst
+  * @param  Frame pointer where the raw and converted samples are written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Read_Frame(LSM6DSO16IS_Async_Frame_t *Frame)
+{
+    uint8_t buff[12];
+
+    co_await lock();
+    /* OUTX_L_G .. OUTZ_H_A */
+    int32_t ret = co_await transfer(0, LSM6DSO16IS_OUTX_L_G, buff, sizeof(buff));
+    unlock();
+
+    if (ret != 0) {
+        co_return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        Frame->gyro_raw[i] = (int16_t)((uint16_t)buff[2U * i] | ((uint16_t)buff[(2U * i) + 1U] << 8));
+        Frame->accel_raw[i] = (int16_t)((uint16_t)buff[6U + (2U * i)] | ((uint16_t)buff[7U + (2U * i)] << 8));
+        Frame->gyro_mdps[i] = (float_t)Frame->gyro_raw[i] * gyro_sensitivity;
+        Frame->acc_mg[i] = (float_t)Frame->accel_raw[i] * acc_sensitivity;
+    }
+
+    co_return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the status of all ISPU events
+  * @param  Status the status of all ISPU events
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Get_ISPU_Status(LSM6DSO16IS_ISPU_Status_t *Status)
+{
+    union {
+      uint8_t buff[4];
+      LSM6DSO16IS_ISPU_Status_t status;
+    } ispu_status;
+
+    co_await lock();
+    int32_t ret = co_await transfer(0, LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE, ispu_status.buff, 4);
+    unlock();
+
+    if (ret != 0) {
+        co_return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    *Status = ispu_status.status;
+    co_return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Read ISPU output registers
+  * @note   The ISPU bank is selected for the whole read and the main bank is
+  *         restored, also on error
+  * @param  Reg address where to start reading
+  * @param  Data pointer where the value is written
+  * @param  len number of registers to read
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Read_ISPU_Output(uint8_t Reg, uint8_t *Data, uint8_t len)
+{
+    lsm6dso16is_func_cfg_access_t func_cfg_access = {};
+    int32_t ret;
+
+    if ((Reg < LSM6DSO16IS_ISPU_DOUT_00_L) || (Reg > LSM6DSO16IS_ISPU_DOUT_31_H)) {
+        co_return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    co_await lock();
+    func_cfg_access.ispu_reg_access = 1;
+    ret = co_await transfer(1, LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+    if (ret == 0) {
+        ret = co_await transfer(0, Reg, Data, len);
+    }
+    func_cfg_access.ispu_reg_access = 0;
+    ret |= co_await transfer(1, LSM6DSO16IS_FUNC_CFG_ACCESS, (uint8_t *)&func_cfg_access, 1);
+    unlock();
+
+    co_return (ret == 0) ? LSM6DSO16IS_STATUS_OK : LSM6DSO16IS_STATUS_ERROR;
+}
+
+/**
+  * @brief  Read consecutive registers
+  * @param  Reg address of the first register
+  * @param  Data pointer where the values are written
+  * @param  Len number of registers to read
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Read_Reg(uint8_t Reg, uint8_t *Data, uint16_t Len)
+{
+    co_await lock();
+    int32_t ret = co_await transfer(0, Reg, Data, Len);
+    unlock();
+
+    co_return (ret == 0) ? LSM6DSO16IS_STATUS_OK : LSM6DSO16IS_STATUS_ERROR;
+}
+
+/**
+  * @brief  Write consecutive registers
+  * @param  Reg address of the first register
+  * @param  Data the values to write, valid until the task returns
+  * @param  Len number of registers to write
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16IS_Task LSM6DSO16IS_Async::Write_Reg(uint8_t Reg, const uint8_t *Data, uint16_t Len)
+{
+    co_await lock();
+    int32_t ret = co_await transfer(1, Reg, (uint8_t *)Data, Len);
+    unlock();
+
+    co_return (ret == 0) ? LSM6DSO16IS_STATUS_OK : LSM6DSO16IS_STATUS_ERROR;
+}
+
+LSM6DSO16IS_Async_Transfer LSM6DSO16IS_Async::transfer(uint8_t write, uint8_t reg, uint8_t *data, uint16_t len)
+{
+    LSM6DSO16IS_Async_Transfer t;
+
+    t.bus = bus;
+    t.op.write = write;
+    t.op.reg = reg;
+    t.op.data = data;
+    t.op.len = len;
+    t.op.status = 1;
+    t.op.loop = loop;
+
+    return t;
+}
+
+void LSM6DSO16IS_Async::unlock(void)
+{
+    /* Hand the device over to the next waiter, if any, without releasing it. */
+    if (lock_waiters.empty()) {
+        locked = 0;
+    } else {
+        loop->Schedule(lock_waiters.front());
+        lock_waiters.pop_front();
+    }
+}
+
+static LSM6DSO16IS_Task benchmark_reader(LSM6DSO16IS_Async *dev, uint32_t rounds, uint32_t *errors)
+{
+    LSM6DSO16IS_Async_Frame_t frame;
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        if (co_await dev->Read_Frame(&frame) != LSM6DSO16IS_STATUS_OK) {
+            (*errors)++;
+        }
+    }
+
+    co_return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Compare the blocking API with the coroutine API on the same buses
+  * @note   Both sides read the 12-byte output frame of every sensor Rounds
+  *         times: the blocking side with LSM6DSO16IS::Read_Reg() sensor after
+  *         sensor from the calling thread, the coroutine side with one
+  *         Read_Frame() task per sensor multiplexed by a loop over one
+  *         LSM6DSO16IS_Async_Bus_Adapter per bus. With independent buses the
+  *         transfers of the coroutine side overlap, so async_ns tends to
+  *         blocking_ns / Count plus the completion overhead.
+  * @param  Buses the sensor buses
+  * @param  Count number of buses
+  * @param  Rounds number of frames read from every sensor
+  * @param  Result pointer where the timings are written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Async_Benchmark(LSM6DSO16IS_Bus **Buses, uint32_t Count, uint32_t Rounds,
+                                                     LSM6DSO16IS_Async_Benchmark_t *Result)
+{
+    std::vector<LSM6DSO16IS *> sensors;
+    std::vector<LSM6DSO16IS_Async_Bus_Adapter *> adapters;
+    std::vector<LSM6DSO16IS_Async *> devices;
+    LSM6DSO16IS_Async_Loop loop;
+    uint8_t buff[12];
+    uint64_t start;
+
+    Result->sensors = Count;
+    Result->rounds = Rounds;
+    Result->errors = 0;
+
+    for (uint32_t i = 0; i < Count; i++) {
+        sensors.push_back(new LSM6DSO16IS(Buses[i]));
+        adapters.push_back(new LSM6DSO16IS_Async_Bus_Adapter(Buses[i]));
+        devices.push_back(new LSM6DSO16IS_Async(adapters[i], &loop));
+        loop.Add_Bus(adapters[i]);
+    }
+
+    start = lsm6dso16is_time_ns();
+    for (uint32_t r = 0; r < Rounds; r++) {
+        for (uint32_t i = 0; i < Count; i++) {
+            if (sensors[i]->Read_Reg(LSM6DSO16IS_OUTX_L_G, buff, sizeof(buff)) != LSM6DSO16IS_STATUS_OK) {
+                Result->errors++;
+            }
+        }
+    }
+    Result->blocking_ns = lsm6dso16is_time_ns() - start;
+
+    start = lsm6dso16is_time_ns();
+    for (uint32_t i = 0; i < Count; i++) {
+        loop.Spawn(benchmark_reader(devices[i], Rounds, &Result->errors));
+    }
+    loop.Run();
+    Result->async_ns = lsm6dso16is_time_ns() - start;
+
+    for (uint32_t i = 0; i < Count; i++) {
+        delete devices[i];
+        delete adapters[i];
+        delete sensors[i];
+    }
+
+    return (loop.Get_Running() == 0U) ? LSM6DSO16IS_STATUS_OK : LSM6DSO16IS_STATUS_ERROR;
+}
+
+#endif // LSM6DSO16IS_HOST_BUILD && __cpp_impl_coroutine
@@ -0,0 +1,270 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_ASYNC_H
+#define LSM6DSO16IS_ASYNC_H
+
+#include "LSM6DSO16IS.h"
+
+/*
+ * Coroutine API for Linux hosts (C++20). One LSM6DSO16IS_Async_Loop thread
+ * multiplexes any number of sensors: each read is an awaitable transaction
+ * submitted to a non-blocking transport (LSM6DSO16IS_Async_Bus), and the
+ * coroutine is resumed by the loop when the transport completes it.
+ *
+ * Linux i2c-dev and spidev transfers are ioctls, which io_uring cannot issue,
+ * so LSM6DSO16IS_Async_Bus_Adapter runs the transactions of a blocking
+ * LSM6DSO16IS_Bus in a worker thread of its own and signals completions on an
+ * eventfd. The loop never blocks on a transfer: it sleeps in poll(2) on the
+ * eventfds of its transports, and the transfers of sensors on different
+ * adapters overlap.
+ */
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__cpp_impl_coroutine)
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class LSM6DSO16IS_Async_Loop;
+
+/* One transaction in flight: the transport sets the status through Complete() */
+struct LSM6DSO16IS_Async_Op {
+  uint8_t write;
+  uint8_t reg;
+  uint8_t *data;
+  uint16_t len;
+  int32_t status;
+  std::coroutine_handle<> waiter;
+  LSM6DSO16IS_Async_Loop *loop;
+
+  void Complete(int32_t Status);
+};
+
+/*
+ * Non-blocking register transport. submit() queues a transaction and returns
+ * at once (non-zero if it cannot be queued); poll() completes the finished
+ * transactions without blocking and returns how many are still in flight.
+ * fd() is a descriptor that becomes readable when poll() has work to do, or -1
+ * if the transport must be polled continuously.
+ */
+class LSM6DSO16IS_Async_Bus {
+public:
+    virtual ~LSM6DSO16IS_Async_Bus() {}
+
+    virtual int32_t submit(LSM6DSO16IS_Async_Op *op) = 0;
+    virtual uint32_t poll(void) = 0;
+    virtual int fd(void) const { return -1; }
+};
+
+/*
+ * Runs the transactions of a blocking bus in a worker thread, in submission
+ * order, and signals each completion on an eventfd.
+ */
+class LSM6DSO16IS_Async_Bus_Adapter : public LSM6DSO16IS_Async_Bus {
+public:
+    explicit LSM6DSO16IS_Async_Bus_Adapter(LSM6DSO16IS_Bus *bus);
+    ~LSM6DSO16IS_Async_Bus_Adapter();
+
+    int32_t submit(LSM6DSO16IS_Async_Op *op) override;
+    uint32_t poll(void) override;
+    int fd(void) const override { return event_fd; }
+
+private:
+    void worker(void);
+
+    LSM6DSO16IS_Bus *bus;
+    int event_fd;
+
+    // Code condivise con il thread di lavoro
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<LSM6DSO16IS_Async_Op *> pending;
+    std::deque<LSM6DSO16IS_Async_Op *> done;
+    bool stop;
+
+    // Transazioni inviate e non ancora completate, solo dal thread del loop
+    uint32_t in_flight;
+    std::thread thread;
+};
+
+/*
+ * Coroutine returning a LSM6DSO16ISStatusTypeDef. Tasks are lazy: they start
+ * when awaited by another task, or when handed to LSM6DSO16IS_Async_Loop::Spawn().
+ */
+class LSM6DSO16IS_Task {
+public:
+    struct promise_type {
+      LSM6DSO16ISStatusTypeDef status = LSM6DSO16IS_STATUS_ERROR;
+      std::coroutine_handle<> continuation;
+      LSM6DSO16IS_Async_Loop *detached = nullptr;
+
+      LSM6DSO16IS_Task get_return_object()
+      {
+        return LSM6DSO16IS_Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+        void await_resume() noexcept {}
+      };
+      final_awaiter final_suspend() noexcept { return {}; }
+      void return_value(LSM6DSO16ISStatusTypeDef Status) { status = Status; }
+      void unhandled_exception() { status = LSM6DSO16IS_STATUS_ERROR; }
+    };
+
+    LSM6DSO16IS_Task(LSM6DSO16IS_Task &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    ~LSM6DSO16IS_Task()
+    {
+      if (handle) {
+        handle.destroy();
+      }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+      handle.promise().continuation = awaiting;
+      return handle;
+    }
+    LSM6DSO16ISStatusTypeDef await_resume() const noexcept { return handle.promise().status; }
+
+private:
+    friend class LSM6DSO16IS_Async_Loop;
+
+    explicit LSM6DSO16IS_Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    LSM6DSO16IS_Task(const LSM6DSO16IS_Task &) = delete;
+    LSM6DSO16IS_Task &operator=(const LSM6DSO16IS_Task &) = delete;
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/*
+ * Single-threaded scheduler: resumes ready coroutines and polls the transports.
+ * Run() sleeps on the transport descriptors while every coroutine waits for a
+ * transfer.
+ */
+class LSM6DSO16IS_Async_Loop {
+public:
+    void Add_Bus(LSM6DSO16IS_Async_Bus *Bus) { buses.push_back(Bus); }
+    void Spawn(LSM6DSO16IS_Task Task);
+    void Schedule(std::coroutine_handle<> Handle) { ready.push_back(Handle); }
+    bool Run_Once(void);
+    void Run(void);
+    uint32_t Get_Running(void) const { return running; }
+
+private:
+    friend struct LSM6DSO16IS_Task::promise_type::final_awaiter;
+
+    void wait(void);
+
+    std::deque<std::coroutine_handle<> > ready;
+    std::vector<LSM6DSO16IS_Async_Bus *> buses;
+    uint32_t running = 0;
+};
+
+/* Awaitable register transaction */
+struct LSM6DSO16IS_Async_Transfer {
+  LSM6DSO16IS_Async_Bus *bus;
+  LSM6DSO16IS_Async_Op op;
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(std::coroutine_handle<> h)
+  {
+    op.waiter = h;
+    if (bus->submit(&op) != 0) {
+      op.status = 1;
+      return false;
+    }
+    return true;
+  }
+  int32_t await_resume() const noexcept { return op.status; }
+};
+
+typedef struct {
+  int16_t gyro_raw[3];
+  int16_t accel_raw[3];
+  float_t gyro_mdps[3];
+  float_t acc_mg[3];
+} LSM6DSO16IS_Async_Frame_t;
+
+typedef struct {
+  uint32_t sensors;
+  uint32_t rounds;
+  uint64_t blocking_ns;
+  uint64_t async_ns;
+  uint32_t errors;
+} LSM6DSO16IS_Async_Benchmark_t;
+
+/*
+ * Awaitable driver for one sensor. Calls on the same instance may run
+ * concurrently: each one owns the device until it returns, so that a
+ * bank-switched ISPU read is never interleaved with an output read.
+ */
+class LSM6DSO16IS_Async {
+public:
+    LSM6DSO16IS_Async(LSM6DSO16IS_Async_Bus *bus, LSM6DSO16IS_Async_Loop *loop);
+
+    LSM6DSO16IS_Task Init(void);
+    LSM6DSO16IS_Task Read_Frame(LSM6DSO16IS_Async_Frame_t *Frame);
+    LSM6DSO16IS_Task Get_ISPU_Status(LSM6DSO16IS_ISPU_Status_t *Status);
+    LSM6DSO16IS_Task Read_ISPU_Output(uint8_t Reg, uint8_t *Data, uint8_t len);
+    LSM6DSO16IS_Task Read_Reg(uint8_t Reg, uint8_t *Data, uint16_t Len);
+    LSM6DSO16IS_Task Write_Reg(uint8_t Reg, const uint8_t *Data, uint16_t Len);
+
+private:
+    struct lock_awaiter {
+      LSM6DSO16IS_Async *dev;
+
+      bool await_ready() const noexcept { return !dev->locked; }
+      void await_suspend(std::coroutine_handle<> h) { dev->lock_waiters.push_back(h); }
+      void await_resume() noexcept { dev->locked = 1; }
+    };
+
+    LSM6DSO16IS_Async_Transfer transfer(uint8_t write, uint8_t reg, uint8_t *data, uint16_t len);
+    lock_awaiter lock(void) { return lock_awaiter{this}; }
+    void unlock(void);
+
+    LSM6DSO16IS_Async_Bus *bus;
+    LSM6DSO16IS_Async_Loop *loop;
+
+    // Accesso esclusivo al dispositivo tra coroutine
+    uint8_t locked;
+    std::deque<std::coroutine_handle<> > lock_waiters;
+
+    // Sensibilita' lette da Init()
+    float_t acc_sensitivity;
+    float_t gyro_sensitivity;
+};
+
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Async_Benchmark(LSM6DSO16IS_Bus **Buses, uint32_t Count, uint32_t Rounds,
+                                                     LSM6DSO16IS_Async_Benchmark_t *Result);
+
+#endif // LSM6DSO16IS_HOST_BUILD && __cpp_impl_coroutine
+
+#endif // LSM6DSO16IS_ASYNC_H
@@ -0,0 +1,62 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_BUS_H
+#define LSM6DSO16IS_BUS_H
+
+#include "LSM6DSO16IS_Platform.h"
+
+/* One burst of consecutive registers in a grouped read */
+typedef struct {
+  uint8_t reg;
+  uint8_t *data;
+  uint16_t len;
+} LSM6DSO16IS_Read_Group_t;
+
+/*
+ * Register access interface used by LSM6DSO16IS instead of its own I2C
+ * instance. Implementations address the sensor, apply the interface framing
+ * (I2C sub-address, SPI read bit) and return 0 on success. read_groups() reads
+ * several bursts; transports that can chain them in one transfer override it.
+ */
+class LSM6DSO16IS_Bus {
+public:
+    virtual ~LSM6DSO16IS_Bus() {}
+
+    virtual int32_t read(uint8_t reg, uint8_t *data, uint16_t len) = 0;
+    virtual int32_t write(uint8_t reg, const uint8_t *data, uint16_t len) = 0;
+    virtual int32_t read_groups(const LSM6DSO16IS_Read_Group_t *groups, uint8_t count)
+    {
+        for (uint8_t i = 0; i < count; i++) {
+            if (read(groups[i].reg, groups[i].data, groups[i].len) != 0) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+};
+
+#endif // LSM6DSO16IS_BUS_H
@@ -0,0 +1,265 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Fanout.h"
+
+/**
+  * @brief  Create a fan-out over a caller allocated ring
+  * @note   len must be a non-zero power of two: sequences are 32-bit counters
+  *         masked into the ring. Any other length leaves the ring unusable,
+  *         and Publish() and Subscribe() then fail
+  * @param  buf the ring storage
+  * @param  len number of samples in buf
+  */
+LSM6DSO16IS_Fanout::LSM6DSO16IS_Fanout(LSM6DSO16IS_Fanout_Sample_t *buf, uint16_t len)
+    : claim(0), head(0)
+{
+    // Sequenze a 32 bit: la dimensione deve essere una potenza di due
+    if ((len == 0U) || ((len & (len - 1U)) != 0U)) {
+        buf = NULL;
+    }
+
+    this->buf = buf;
+    mask = (buf == NULL) ? 0U : (uint32_t)(len - 1U);
+    for (uint8_t i = 0; i < LSM6DSO16IS_FANOUT_MAX_CONSUMERS; i++) {
+        consumers[i].active = 0;
+    }
+}
+
+/**
+  * @brief  Write one sample into the ring
+  * @note   Never blocks: the slot of the sample published one ring size earlier
+  *         is overwritten
+  * @param  Sample the sample
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Publish(const LSM6DSO16IS_Fanout_Sample_t *Sample)
+{
+    uint32_t seq = head.load(std::memory_order_relaxed);
+
+    if (buf == NULL) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    /* Announce the overwrite before touching the slot, publish after. */
+    claim.store(seq + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    buf[seq & mask] = *Sample;
+    head.store(seq + 1U, std::memory_order_release);
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Read both sensors in one burst and publish the sample
+  * @param  sensor the sensor to read
+  * @param  Timestamp the timestamp stored with the sample
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Poll(LSM6DSO16IS *sensor, uint32_t Timestamp)
+{
+    LSM6DSO16IS_Fanout_Sample_t sample;
+    uint8_t buff[12];
+
+    /* OUTX_L_G .. OUTZ_H_A: gyroscope then accelerometer. */
+    if (sensor->Read_Reg(LSM6DSO16IS_OUTX_L_G, buff, sizeof(buff)) != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    sample.timestamp = Timestamp;
+    for (uint8_t i = 0; i < 3U; i++) {
+        sample.gyro[i] = (int16_t)((uint16_t)buff[2U * i] | ((uint16_t)buff[(2U * i) + 1U] << 8));
+        sample.accel[i] = (int16_t)((uint16_t)buff[6U + (2U * i)] | ((uint16_t)buff[7U + (2U * i)] << 8));
+    }
+
+    return Publish(&sample);
+}
+
+/**
+  * @brief  Add a consumer, starting from the next published sample
+  * @param  Id pointer where the consumer id is written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Subscribe(uint8_t *Id)
+{
+    if (buf == NULL) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    for (uint8_t i = 0; i < LSM6DSO16IS_FANOUT_MAX_CONSUMERS; i++) {
+        if (consumers[i].active == 0U) {
+            consumers[i].cursor = head.load(std::memory_order_acquire);
+            consumers[i].stats.read = 0;
+            consumers[i].stats.dropped = 0;
+            consumers[i].stats.lag = 0;
+            consumers[i].stats.max_lag = 0;
+            consumers[i].active = 1;
+            *Id = i;
+            return LSM6DSO16IS_STATUS_OK;
+        }
+    }
+
+    return LSM6DSO16IS_STATUS_ERROR;
+}
+
+/**
+  * @brief  Remove a consumer
+  * @param  Id the consumer id
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Unsubscribe(uint8_t Id)
+{
+    if ((Id >= LSM6DSO16IS_FANOUT_MAX_CONSUMERS) || (consumers[Id].active == 0U)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    consumers[Id].active = 0;
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the next sample of a consumer without copying it
+  * @note   The sample stays in the ring: call Release() when done with it
+  * @param  Id the consumer id
+  * @retval pointer to the sample, NULL if there is no new sample
+  */
+const LSM6DSO16IS_Fanout_Sample_t *LSM6DSO16IS_Fanout::Peek(uint8_t Id)
+{
+    consumer_t *c;
+
+    if ((Id >= LSM6DSO16IS_FANOUT_MAX_CONSUMERS) || (consumers[Id].active == 0U)) {
+        return NULL;
+    }
+
+    c = &consumers[Id];
+    if (!catch_up(c, head.load(std::memory_order_acquire))) {
+        return NULL;
+    }
+
+    return &buf[c->cursor & mask];
+}
+
+/**
+  * @brief  Release the sample returned by Peek() and move to the next one
+  * @param  Id the consumer id
+  * @retval 0 if the sample was intact while in use, an error code if the
+  *         producer overwrote it (the sample is then counted as dropped)
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Release(uint8_t Id)
+{
+    consumer_t *c;
+    bool ok;
+
+    if ((Id >= LSM6DSO16IS_FANOUT_MAX_CONSUMERS) || (consumers[Id].active == 0U)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    c = &consumers[Id];
+    if (c->cursor == head.load(std::memory_order_acquire)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    ok = intact(c->cursor);
+    c->cursor++;
+    if (ok) {
+        c->stats.read++;
+    } else {
+        c->stats.dropped++;
+    }
+
+    return ok ? LSM6DSO16IS_STATUS_OK : LSM6DSO16IS_STATUS_ERROR;
+}
+
+/**
+  * @brief  Copy the next sample of a consumer
+  * @note   A sample overwritten during the copy is dropped and the next one is
+  *         tried
+  * @param  Id the consumer id
+  * @param  Out pointer where the sample is written
+  * @retval 0 in case of success, an error code if there is no new sample
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Read(uint8_t Id, LSM6DSO16IS_Fanout_Sample_t *Out)
+{
+    const LSM6DSO16IS_Fanout_Sample_t *sample;
+
+    while ((sample = Peek(Id)) != NULL) {
+        *Out = *sample;
+        if (Release(Id) == LSM6DSO16IS_STATUS_OK) {
+            return LSM6DSO16IS_STATUS_OK;
+        }
+    }
+
+    return LSM6DSO16IS_STATUS_ERROR;
+}
+
+/**
+  * @brief  Get the counters of a consumer
+  * @note   lag is the number of published samples not yet read by the consumer
+  * @param  Id the consumer id
+  * @param  Stats pointer where the counters are written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Fanout::Get_Stats(uint8_t Id, LSM6DSO16IS_Fanout_Stats_t *Stats)
+{
+    if ((Id >= LSM6DSO16IS_FANOUT_MAX_CONSUMERS) || (consumers[Id].active == 0U)) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    *Stats = consumers[Id].stats;
+    Stats->lag = head.load(std::memory_order_acquire) - consumers[Id].cursor;
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+bool LSM6DSO16IS_Fanout::catch_up(consumer_t *c, uint32_t published)
+{
+    uint32_t oldest;
+    uint32_t lag = published - c->cursor;
+
+    if (lag == 0U) {
+        return false;
+    }
+    if (lag > c->stats.max_lag) {
+        c->stats.max_lag = lag;
+    }
+
+    /* Lapped by the producer: skip to the oldest sample still in the ring. */
+    if (!intact(c->cursor)) {
+        oldest = claim.load(std::memory_order_relaxed) - mask - 1U;
+        c->stats.dropped += oldest - c->cursor;
+        c->cursor = oldest;
+    }
+
+    return c->cursor != published;
+}
+
+bool LSM6DSO16IS_Fanout::intact(uint32_t seq) const
+{
+    /* The write of sequence n overwrites sequence n - size. */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (claim.load(std::memory_order_relaxed) - seq) <= (mask + 1U);
+}
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_FANOUT_H
+#define LSM6DSO16IS_FANOUT_H
+
+#include "LSM6DSO16IS.h"
+#include <atomic>
+
+#define LSM6DSO16IS_FANOUT_MAX_CONSUMERS    4U
+
+/* One sample of both sensors, raw LSB */
+typedef struct {
+  uint32_t timestamp;
+  int32_t accel[3];
+  int32_t gyro[3];
+} LSM6DSO16IS_Fanout_Sample_t;
+
+typedef struct {
+  uint32_t read;
+  uint32_t dropped;
+  uint32_t lag;
+  uint32_t max_lag;
+} LSM6DSO16IS_Fanout_Stats_t;
+
+/*
+ * Single-producer, multi-consumer fan-out of the sample stream. The producer
+ * writes each sample once into a ring allocated by the caller, whose length
+ * must be a power of two (Poll() costs one burst read whatever the number of
+ * consumers); every consumer reads through its own cursor, like a disruptor
+ * sequence barrier. The producer never waits:
+ * a consumer lagging more than the ring size loses the oldest samples, which
+ * are counted in its drop counter.
+ *
+ * Peek() returns a pointer into the ring, so a consumer can use the sample in
+ * place; Release() then checks that the producer did not overwrite it in the
+ * meantime. Read() is the copying variant. Publish()/Poll() must be called from
+ * one thread only, and each consumer id from one thread only; Subscribe() and
+ * Unsubscribe() are meant to be called before the stream starts.
+ */
+class LSM6DSO16IS_Fanout {
+public:
+    LSM6DSO16IS_Fanout(LSM6DSO16IS_Fanout_Sample_t *buf, uint16_t len);
+
+    LSM6DSO16ISStatusTypeDef Publish(const LSM6DSO16IS_Fanout_Sample_t *Sample);
+    LSM6DSO16ISStatusTypeDef Poll(LSM6DSO16IS *sensor, uint32_t Timestamp);
+    uint32_t Get_Published(void) const { return head.load(std::memory_order_acquire); }
+
+    LSM6DSO16ISStatusTypeDef Subscribe(uint8_t *Id);
+    LSM6DSO16ISStatusTypeDef Unsubscribe(uint8_t Id);
+    const LSM6DSO16IS_Fanout_Sample_t *Peek(uint8_t Id);
+    LSM6DSO16ISStatusTypeDef Release(uint8_t Id);
+    LSM6DSO16ISStatusTypeDef Read(uint8_t Id, LSM6DSO16IS_Fanout_Sample_t *Out);
+    LSM6DSO16ISStatusTypeDef Get_Stats(uint8_t Id, LSM6DSO16IS_Fanout_Stats_t *Stats);
+
+private:
+    typedef struct {
+      uint8_t active;
+      uint32_t cursor;
+      LSM6DSO16IS_Fanout_Stats_t stats;
+    } consumer_t;
+
+    bool catch_up(consumer_t *c, uint32_t published);
+    bool intact(uint32_t seq) const;
+
+    LSM6DSO16IS_Fanout_Sample_t *buf;
+    uint32_t mask;
+
+    // Numero di campioni iniziati (claim) e pubblicati (head) dal produttore
+    std::atomic<uint32_t> claim;
+    std::atomic<uint32_t> head;
+
+    consumer_t consumers[LSM6DSO16IS_FANOUT_MAX_CONSUMERS];
+};
+
+#endif // LSM6DSO16IS_FANOUT_H
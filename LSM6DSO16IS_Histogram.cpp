@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Histogram.h"
+
+LSM6DSO16IS_Histogram::LSM6DSO16IS_Histogram()
+{
+    Reset();
+}
+
+/**
+ * @brief  Copy the histogram, optionally clearing it
+ * @param  Snapshot buckets, count, max in ticks and the tick frequency
+ * @param  Reset 1 to clear each bucket as it is copied
+ */
+void LSM6DSO16IS_Histogram::Snapshot(LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Reset)
+{
+    Snapshot->count = 0;
+    for (uint32_t i = 0; i < LSM6DSO16IS_HISTOGRAM_BUCKETS; i++) {
+        Snapshot->buckets[i] = Reset ? buckets[i].exchange(0U, std::memory_order_relaxed)
+                               : buckets[i].load(std::memory_order_relaxed);
+        Snapshot->count += Snapshot->buckets[i];
+    }
+    Snapshot->max = Reset ? max.exchange(0U, std::memory_order_relaxed) : max.load(std::memory_order_relaxed);
+    Snapshot->hz = lsm6dso16is_cycles_hz();
+}
+
+void LSM6DSO16IS_Histogram::Reset(void)
+{
+    for (uint32_t i = 0; i < LSM6DSO16IS_HISTOGRAM_BUCKETS; i++) {
+        buckets[i].store(0U, std::memory_order_relaxed);
+    }
+    max.store(0U, std::memory_order_relaxed);
+}
+
+/**
+ * @brief  Duration below which Percent of the recorded durations fall
+ * @param  Snapshot taken with Snapshot()
+ * @param  Percent 1..100
+ * @retval the upper bound of the bucket holding the percentile, in ns; 0 if empty
+ */
+uint32_t LSM6DSO16IS_Histogram::Percentile(const LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Percent)
+{
+    // Rango del percentile, arrotondato per eccesso
+    uint64_t rank = ((uint64_t)Snapshot->count * Percent + 99U) / 100U;
+    uint64_t seen = 0;
+
+    if (rank == 0U) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < LSM6DSO16IS_HISTOGRAM_BUCKETS; i++) {
+        seen += Snapshot->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = (i == 0U) ? 0U : (uint32_t)((1ULL << i) - 1U);
+            return to_ns((upper < Snapshot->max) ? upper : Snapshot->max, Snapshot->hz);
+        }
+    }
+
+    return to_ns(Snapshot->max, Snapshot->hz);
+}
+
+/**
+ * @brief  Count, p50, p99 and max of a snapshot, in ns
+ */
+void LSM6DSO16IS_Histogram::Summarize(const LSM6DSO16IS_Histogram_Snapshot_t *Snapshot,
+                                      LSM6DSO16IS_Latency_Summary_t *Summary)
+{
+    Summary->count = Snapshot->count;
+    Summary->p50_ns = Percentile(Snapshot, 50U);
+    Summary->p99_ns = Percentile(Snapshot, 99U);
+    Summary->max_ns = to_ns(Snapshot->max, Snapshot->hz);
+}
+
+uint32_t LSM6DSO16IS_Histogram::to_ns(uint32_t cycles, uint32_t hz)
+{
+    uint64_t ns = ((uint64_t)cycles * 1000000000U) / ((hz != 0U) ? hz : 1U);
+
+    return (ns > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)ns;
+}
@@ -0,0 +1,88 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_HISTOGRAM_H
+#define LSM6DSO16IS_HISTOGRAM_H
+
+#include "LSM6DSO16IS_Platform.h"
+#include <atomic>
+
+/* Bucket 0 holds zero, bucket b durations in [2^(b-1), 2^b - 1] ticks */
+#define LSM6DSO16IS_HISTOGRAM_BUCKETS   33U
+
+typedef struct {
+  uint32_t buckets[LSM6DSO16IS_HISTOGRAM_BUCKETS];
+  uint32_t count;
+  uint32_t max;
+  uint32_t hz;
+} LSM6DSO16IS_Histogram_Snapshot_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t p50_ns;
+  uint32_t p99_ns;
+  uint32_t max_ns;
+} LSM6DSO16IS_Latency_Summary_t;
+
+/*
+ * Log2 latency histogram of lsm6dso16is_cycles() durations. Record() is
+ * lock-free and safe from interrupts and concurrent threads: one relaxed
+ * increment, plus a compare-and-swap only when the maximum grows. Snapshot()
+ * may run concurrently with Record(); with Reset set each duration ends up in
+ * exactly one snapshot. Percentiles are the upper bound of their bucket, so
+ * they overestimate by less than a factor of two, and never exceed the max.
+ */
+class LSM6DSO16IS_Histogram {
+public:
+    LSM6DSO16IS_Histogram();
+
+    void Record(uint32_t Cycles)
+    {
+        uint32_t bucket = (Cycles == 0U) ? 0U : (32U - (uint32_t)__builtin_clz(Cycles));
+        uint32_t prev = max.load(std::memory_order_relaxed);
+
+        buckets[bucket].fetch_add(1U, std::memory_order_relaxed);
+        while ((Cycles > prev) && !max.compare_exchange_weak(prev, Cycles, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Snapshot(LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Reset);
+    void Reset(void);
+    static uint32_t Percentile(const LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, uint8_t Percent);
+    static void Summarize(const LSM6DSO16IS_Histogram_Snapshot_t *Snapshot, LSM6DSO16IS_Latency_Summary_t *Summary);
+
+private:
+    // Contatori dei bucket e durata massima, in tick
+    std::atomic<uint32_t> buckets[LSM6DSO16IS_HISTOGRAM_BUCKETS];
+    std::atomic<uint32_t> max;
+
+    static uint32_t to_ns(uint32_t cycles, uint32_t hz);
+
+    LSM6DSO16IS_Histogram(const LSM6DSO16IS_Histogram &);
+    LSM6DSO16IS_Histogram &operator=(const LSM6DSO16IS_Histogram &);
+};
+
+#endif // LSM6DSO16IS_HISTOGRAM_H
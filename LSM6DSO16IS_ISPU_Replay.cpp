@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_ISPU_Replay.h"
+#include <cstring>
+
+LSM6DSO16IS_ISPU_Replay::LSM6DSO16IS_ISPU_Replay(const LSM6DSO16IS_ISPU_Record_t *records, uint32_t count)
+{
+    this->records = records;
+    this->count = count;
+
+    func_cfg_access = 0;
+    memset(main_page, 0, sizeof(main_page));
+    memset(shub_page, 0, sizeof(shub_page));
+    memset(ispu_page, 0, sizeof(ispu_page));
+
+    // Valori di reset rilevanti per il driver
+    main_page[LSM6DSO16IS_WHO_AM_I] = LSM6DSO16IS_ID;
+    main_page[LSM6DSO16IS_CTRL3_C] = 0x04U; // if_inc
+
+    Rewind();
+    Reset_Counters();
+}
+
+uint8_t *LSM6DSO16IS_ISPU_Replay::page(void)
+{
+    lsm6dso16is_func_cfg_access_t *access = (lsm6dso16is_func_cfg_access_t *)&func_cfg_access;
+
+    if (access->ispu_reg_access) {
+        return ispu_page;
+    }
+    if (access->shub_reg_access) {
+        return shub_page;
+    }
+    return main_page;
+}
+
+int32_t LSM6DSO16IS_ISPU_Replay::read(uint8_t reg, uint8_t *data, uint16_t len)
+{
+    lsm6dso16is_ctrl3_c_t *ctrl3_c = (lsm6dso16is_ctrl3_c_t *)&main_page[LSM6DSO16IS_CTRL3_C];
+    uint8_t *regs = page();
+
+    transactions++;
+    bytes += len + 1U;
+
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t addr = (uint8_t)((reg + ((ctrl3_c->if_inc != 0U) ? i : 0U)) & (LSM6DSO16IS_REPLAY_PAGE_SIZE - 1U));
+        data[i] = (addr == LSM6DSO16IS_FUNC_CFG_ACCESS) ? func_cfg_access : regs[addr];
+    }
+
+    return 0;
+}
+
+int32_t LSM6DSO16IS_ISPU_Replay::write(uint8_t reg, const uint8_t *data, uint16_t len)
+{
+    lsm6dso16is_ctrl3_c_t *ctrl3_c = (lsm6dso16is_ctrl3_c_t *)&main_page[LSM6DSO16IS_CTRL3_C];
+
+    transactions++;
+    bytes += len + 1U;
+
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t addr = (uint8_t)((reg + ((ctrl3_c->if_inc != 0U) ? i : 0U)) & (LSM6DSO16IS_REPLAY_PAGE_SIZE - 1U));
+        if (addr == LSM6DSO16IS_FUNC_CFG_ACCESS) {
+            if ((data[i] & 0xC0U) != (func_cfg_access & 0xC0U)) {
+                bank_switches++;
+            }
+            func_cfg_access = data[i];
+        } else {
+            page()[addr] = data[i];
+        }
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  Load the next recorded event into the register bank
+  * @retval false when all the events have been replayed
+  */
+bool LSM6DSO16IS_ISPU_Replay::Next_Event(void)
+{
+    const LSM6DSO16IS_ISPU_Record_t *record;
+
+    if (position >= count) {
+        return false;
+    }
+    record = &records[position++];
+
+    for (uint8_t i = 0; i < 4U; i++) {
+        uint8_t val = (uint8_t)(record->int_status >> (8U * i));
+        main_page[LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE + i] = val;
+        ispu_page[LSM6DSO16IS_ISPU_INT_STATUS0 + i] = val;
+    }
+    memcpy(&ispu_page[LSM6DSO16IS_ISPU_DOUT_00_L], record->dout, LSM6DSO16IS_ISPU_DOUT_LEN);
+
+    return true;
+}
+
+void LSM6DSO16IS_ISPU_Replay::Rewind(void)
+{
+    position = 0;
+}
+
+void LSM6DSO16IS_ISPU_Replay::Reset_Counters(void)
+{
+    transactions = 0;
+    bytes = 0;
+    bank_switches = 0;
+}
+
+/**
+  * @brief  Replay all the recorded events through the ISPU read path
+  * @note   For each event Get_ISPU_Status() and Read_ISPU_Output() are called
+  *         on sensor, which must be built on this bus, then decoder is run on
+  *         the result. Bus and decode costs are reported separately.
+  * @param  sensor driver instance using this replay as its bus
+  * @param  Reg first ISPU output register read for each event
+  * @param  len number of ISPU output registers read for each event
+  * @param  decoder user decoding, may be NULL to measure the read path only
+  * @param  ctx context passed to decoder
+  * @param  report pointer where the results are written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ISPU_Replay::Run_Benchmark(LSM6DSO16IS *sensor, uint8_t Reg, uint8_t len,
+                                                                LSM6DSO16IS_ISPU_Decoder_t decoder, void *ctx,
+                                                                LSM6DSO16IS_ISPU_Bench_Report_t *report)
+{
+    LSM6DSO16ISStatusTypeDef ret = LSM6DSO16IS_STATUS_OK;
+    LSM6DSO16IS_ISPU_Status_t status;
+    uint8_t dout[LSM6DSO16IS_ISPU_DOUT_LEN];
+    uint64_t t0, t1, t2;
+
+    if (len > LSM6DSO16IS_ISPU_DOUT_LEN) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    memset(report, 0, sizeof(*report));
+    Rewind();
+    Reset_Counters();
+
+    while (Next_Event()) {
+        t0 = lsm6dso16is_time_ns();
+        if (sensor->Get_ISPU_Status(&status) != LSM6DSO16IS_STATUS_OK) {
+            ret = LSM6DSO16IS_STATUS_ERROR;
+        }
+        if (sensor->Read_ISPU_Output(Reg, dout, len) != LSM6DSO16IS_STATUS_OK) {
+            ret = LSM6DSO16IS_STATUS_ERROR;
+        }
+        t1 = lsm6dso16is_time_ns();
+        if (decoder != NULL) {
+            decoder(&status, dout, len, ctx);
+        }
+        t2 = lsm6dso16is_time_ns();
+
+        report->read_ns += t1 - t0;
+        report->decode_ns += t2 - t1;
+        report->events++;
+    }
+
+    report->transactions = transactions;
+    report->bytes = bytes;
+    report->bank_switches = bank_switches;
+    if (report->events != 0U) {
+        report->transactions_per_event = (float)report->transactions / (float)report->events;
+        report->bytes_per_event = (float)report->bytes / (float)report->events;
+        report->read_ns_per_event = (float)report->read_ns / (float)report->events;
+        report->decode_ns_per_event = (float)report->decode_ns / (float)report->events;
+    }
+
+    return ret;
+}
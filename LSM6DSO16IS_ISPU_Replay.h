@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_ISPU_REPLAY_H
+#define LSM6DSO16IS_ISPU_REPLAY_H
+
+#include "LSM6DSO16IS.h"
+
+#define LSM6DSO16IS_REPLAY_PAGE_SIZE     128U
+#define LSM6DSO16IS_ISPU_DOUT_LEN        ((LSM6DSO16IS_ISPU_DOUT_31_H - LSM6DSO16IS_ISPU_DOUT_00_L) + 1U)
+
+/* One recorded ISPU event: the interrupt status word and the DOUT snapshot. */
+typedef struct {
+  uint32_t int_status;
+  uint8_t dout[LSM6DSO16IS_ISPU_DOUT_LEN];
+} LSM6DSO16IS_ISPU_Record_t;
+
+/* User decoding of one ISPU event, as done on the target after Read_ISPU_Output(). */
+typedef void (*LSM6DSO16IS_ISPU_Decoder_t)(const LSM6DSO16IS_ISPU_Status_t *status,
+                                           const uint8_t *dout, uint8_t len, void *ctx);
+
+typedef struct {
+  uint32_t events;
+  uint32_t transactions;
+  uint32_t bytes;
+  uint32_t bank_switches;
+  uint64_t read_ns;
+  uint64_t decode_ns;
+  float transactions_per_event;
+  float bytes_per_event;
+  float read_ns_per_event;
+  float decode_ns_per_event;
+} LSM6DSO16IS_ISPU_Bench_Report_t;
+
+/*
+ * Simulated register bank that replays recorded ISPU events, so that the ISPU
+ * read path of LSM6DSO16IS and the user decoding can be profiled without the
+ * sensor. Each bus call counts as one transaction; the byte count includes the
+ * register address byte.
+ */
+class LSM6DSO16IS_ISPU_Replay : public LSM6DSO16IS_Bus {
+public:
+    LSM6DSO16IS_ISPU_Replay(const LSM6DSO16IS_ISPU_Record_t *records, uint32_t count);
+
+    int32_t read(uint8_t reg, uint8_t *data, uint16_t len);
+    int32_t write(uint8_t reg, const uint8_t *data, uint16_t len);
+
+    bool Next_Event(void);
+    void Rewind(void);
+    void Reset_Counters(void);
+    uint32_t Get_Transactions(void) const { return transactions; }
+    uint32_t Get_Bytes(void) const { return bytes; }
+    uint32_t Get_Bank_Switches(void) const { return bank_switches; }
+
+    LSM6DSO16ISStatusTypeDef Run_Benchmark(LSM6DSO16IS *sensor, uint8_t Reg, uint8_t len,
+                                           LSM6DSO16IS_ISPU_Decoder_t decoder, void *ctx,
+                                           LSM6DSO16IS_ISPU_Bench_Report_t *report);
+
+private:
+    uint8_t *page(void);
+
+    const LSM6DSO16IS_ISPU_Record_t *records;
+    uint32_t count;
+    uint32_t position;
+
+    uint8_t func_cfg_access;
+    uint8_t main_page[LSM6DSO16IS_REPLAY_PAGE_SIZE];
+    uint8_t shub_page[LSM6DSO16IS_REPLAY_PAGE_SIZE];
+    uint8_t ispu_page[LSM6DSO16IS_REPLAY_PAGE_SIZE];
+
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t bank_switches;
+};
+
+#endif // LSM6DSO16IS_ISPU_REPLAY_H
@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Linux_I2C.h"
+
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+static int lsm6dso16is_sys_ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    (void)ctx;
+    return ioctl(fd, request, arg);
+}
+
+LSM6DSO16IS_Linux_I2C::LSM6DSO16IS_Linux_I2C(uint8_t address)
+{
+    fd = -1;
+    this->address = address;
+    ioctl_fn = lsm6dso16is_sys_ioctl;
+    ioctl_ctx = NULL;
+    syscalls = 0;
+}
+
+LSM6DSO16IS_Linux_I2C::~LSM6DSO16IS_Linux_I2C()
+{
+    Close();
+}
+
+/**
+  * @brief  Open the I2C adapter
+  * @param  Device the adapter device node, e.g. "/dev/i2c-1"
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Linux_I2C::Open(const char *Device)
+{
+    unsigned long funcs = 0;
+
+    Close();
+    fd = open(Device, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    /* Combined transfers need an adapter that supports I2C_RDWR. */
+    if ((ioctl_fn(ioctl_ctx, fd, I2C_FUNCS, &funcs) < 0) || ((funcs & I2C_FUNC_I2C) == 0U)) {
+        Close();
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Close the I2C adapter
+  */
+void LSM6DSO16IS_Linux_I2C::Close(void)
+{
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**
+  * @brief  Replace the ioctl() used for the transfers
+  * @note   With a mock device no adapter needs to be opened
+  * @param  Ioctl the replacement, NULL to restore the system call
+  * @param  Ctx the context passed to Ioctl
+  */
+void LSM6DSO16IS_Linux_I2C::Set_Ioctl(LSM6DSO16IS_Ioctl_t Ioctl, void *Ctx)
+{
+    ioctl_fn = (Ioctl != NULL) ? Ioctl : lsm6dso16is_sys_ioctl;
+    ioctl_ctx = Ctx;
+}
+
+int32_t LSM6DSO16IS_Linux_I2C::read(uint8_t reg, uint8_t *data, uint16_t len)
+{
+    LSM6DSO16IS_Read_Group_t group = { reg, data, len };
+
+    return read_groups(&group, 1);
+}
+
+int32_t LSM6DSO16IS_Linux_I2C::write(uint8_t reg, const uint8_t *data, uint16_t len)
+{
+    uint8_t buff[LSM6DSO16IS_MAX_WRITE_LEN + 1U];
+    struct i2c_msg msg;
+
+    if (len > LSM6DSO16IS_MAX_WRITE_LEN) {
+        errno = EINVAL;
+        return 1;
+    }
+
+    buff[0] = reg;
+    memcpy(&buff[1], data, len);
+    msg.addr = address;
+    msg.flags = 0;
+    msg.len = (uint16_t)(len + 1U);
+    msg.buf = buff;
+
+    return transfer(&msg, 1);
+}
+
+int32_t LSM6DSO16IS_Linux_I2C::read_groups(const LSM6DSO16IS_Read_Group_t *groups, uint8_t count)
+{
+    struct i2c_msg msgs[2U * LSM6DSO16IS_I2C_MAX_GROUPS];
+    uint8_t regs[LSM6DSO16IS_I2C_MAX_GROUPS];
+    uint8_t n;
+
+    if (count == 0U) {
+        errno = EINVAL;
+        return 1;
+    }
+
+    /* One ioctl per LSM6DSO16IS_I2C_MAX_GROUPS groups */
+    for (uint8_t first = 0; first < count; first = (uint8_t)(first + n)) {
+        n = (uint8_t)(count - first);
+        if (n > LSM6DSO16IS_I2C_MAX_GROUPS) {
+            n = LSM6DSO16IS_I2C_MAX_GROUPS;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            regs[i] = groups[first + i].reg;
+            msgs[2U * i].addr = address;
+            msgs[2U * i].flags = 0;
+            msgs[2U * i].len = 1;
+            msgs[2U * i].buf = &regs[i];
+            msgs[(2U * i) + 1U].addr = address;
+            msgs[(2U * i) + 1U].flags = I2C_M_RD;
+            msgs[(2U * i) + 1U].len = groups[first + i].len;
+            msgs[(2U * i) + 1U].buf = groups[first + i].data;
+        }
+
+        if (transfer(msgs, 2U * n) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int32_t LSM6DSO16IS_Linux_I2C::transfer(struct i2c_msg *msgs, uint32_t count)
+{
+    struct i2c_rdwr_ioctl_data rdwr;
+    int ret;
+
+    if ((fd < 0) && (ioctl_fn == lsm6dso16is_sys_ioctl)) {
+        errno = EBADF;
+        return 1;
+    }
+
+    rdwr.msgs = msgs;
+    rdwr.nmsgs = count;
+    do {
+        syscalls++;
+        ret = ioctl_fn(ioctl_ctx, fd, I2C_RDWR, &rdwr);
+    } while ((ret < 0) && (errno == EINTR));
+
+    /* I2C_RDWR returns the number of messages transferred: on a short
+       transfer errno is not set by the kernel. */
+    if ((ret >= 0) && (ret != (int)count)) {
+        errno = EIO;
+    }
+
+    return (ret == (int)count) ? 0 : 1;
+}
+
+#endif // LSM6DSO16IS_HOST_BUILD && __linux__
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_LINUX_I2C_H
+#define LSM6DSO16IS_LINUX_I2C_H
+
+#include "LSM6DSO16IS.h"
+
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__linux__)
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define LSM6DSO16IS_I2C_ADDRESS          0x6AU
+/* Each group is a sub-address write plus a read */
+#define LSM6DSO16IS_I2C_MAX_GROUPS       (I2C_RDWR_IOCTL_MAX_MSGS / 2U)
+
+/*
+ * Linux userspace I2C transport over /dev/i2c-N. Every register access is one
+ * I2C_RDWR ioctl: a read is the sub-address write and the read joined by a
+ * repeated start, and read_groups() chains up to LSM6DSO16IS_I2C_MAX_GROUPS such
+ * pairs in the same ioctl, so a whole sample costs one system call; larger
+ * batches are split into several ioctls. A failed access returns non-zero with
+ * errno set, interrupted ioctls are restarted.
+ */
+class LSM6DSO16IS_Linux_I2C : public LSM6DSO16IS_Bus {
+public:
+    explicit LSM6DSO16IS_Linux_I2C(uint8_t address = LSM6DSO16IS_I2C_ADDRESS);
+    ~LSM6DSO16IS_Linux_I2C();
+
+    LSM6DSO16ISStatusTypeDef Open(const char *Device);
+    void Close(void);
+    void Set_Ioctl(LSM6DSO16IS_Ioctl_t Ioctl, void *Ctx);
+    uint32_t Get_Syscalls(void) const { return syscalls; }
+
+    int32_t read(uint8_t reg, uint8_t *data, uint16_t len) override;
+    int32_t write(uint8_t reg, const uint8_t *data, uint16_t len) override;
+    int32_t read_groups(const LSM6DSO16IS_Read_Group_t *groups, uint8_t count) override;
+
+private:
+    int32_t transfer(struct i2c_msg *msgs, uint32_t count);
+
+    int fd;
+    uint16_t address;
+    LSM6DSO16IS_Ioctl_t ioctl_fn;
+    void *ioctl_ctx;
+    uint32_t syscalls;
+};
+
+#endif // LSM6DSO16IS_HOST_BUILD && __linux__
+
+#endif // LSM6DSO16IS_LINUX_I2C_H
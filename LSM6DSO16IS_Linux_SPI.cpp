@@ -0,0 +1,196 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Linux_SPI.h"
+
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+static int lsm6dso16is_spidev_ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    (void)ctx;
+    return ioctl(fd, request, arg);
+}
+
+LSM6DSO16IS_Linux_SPI::LSM6DSO16IS_Linux_SPI()
+{
+    fd = -1;
+    speed_hz = LSM6DSO16IS_SPIDEV_SPEED_HZ;
+    ioctl_fn = lsm6dso16is_spidev_ioctl;
+    ioctl_ctx = NULL;
+    syscalls = 0;
+}
+
+LSM6DSO16IS_Linux_SPI::~LSM6DSO16IS_Linux_SPI()
+{
+    Close();
+}
+
+/**
+  * @brief  Open and configure the spidev device
+  * @param  Device the device node, e.g. "/dev/spidev0.0"
+  * @param  Speed_Hz the clock frequency, up to 10 MHz
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Linux_SPI::Open(const char *Device, uint32_t Speed_Hz)
+{
+    uint8_t mode = SPI_MODE_3;
+    uint8_t bits = 8;
+
+    Close();
+    fd = open(Device, O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    speed_hz = Speed_Hz;
+    if ((ioctl_fn(ioctl_ctx, fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+        (ioctl_fn(ioctl_ctx, fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+        (ioctl_fn(ioctl_ctx, fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz) < 0)) {
+        Close();
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Close the spidev device
+  */
+void LSM6DSO16IS_Linux_SPI::Close(void)
+{
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**
+  * @brief  Replace the ioctl() used for the transfers
+  * @note   With a mock device no spidev node needs to be opened
+  * @param  Ioctl the replacement, NULL to restore the system call
+  * @param  Ctx the context passed to Ioctl
+  */
+void LSM6DSO16IS_Linux_SPI::Set_Ioctl(LSM6DSO16IS_Ioctl_t Ioctl, void *Ctx)
+{
+    ioctl_fn = (Ioctl != NULL) ? Ioctl : lsm6dso16is_spidev_ioctl;
+    ioctl_ctx = Ctx;
+}
+
+int32_t LSM6DSO16IS_Linux_SPI::read(uint8_t reg, uint8_t *data, uint16_t len)
+{
+    LSM6DSO16IS_Read_Group_t group = { reg, data, len };
+
+    return read_groups(&group, 1);
+}
+
+int32_t LSM6DSO16IS_Linux_SPI::write(uint8_t reg, const uint8_t *data, uint16_t len)
+{
+    struct spi_ioc_transfer xfers[2];
+    uint8_t cmd = reg & (uint8_t)~LSM6DSO16IS_SPI_READ;
+
+    memset(xfers, 0, sizeof(xfers));
+    xfers[0].tx_buf = (uintptr_t)&cmd;
+    xfers[0].len = 1;
+    xfers[1].tx_buf = (uintptr_t)data;
+    xfers[1].len = len;
+
+    return transfer(xfers, 2);
+}
+
+int32_t LSM6DSO16IS_Linux_SPI::read_groups(const LSM6DSO16IS_Read_Group_t *groups, uint8_t count)
+{
+    struct spi_ioc_transfer xfers[2U * LSM6DSO16IS_SPIDEV_MAX_GROUPS];
+    uint8_t cmds[LSM6DSO16IS_SPIDEV_MAX_GROUPS];
+    uint8_t n;
+
+    if (count == 0U) {
+        errno = EINVAL;
+        return 1;
+    }
+
+    /* One message per LSM6DSO16IS_SPIDEV_MAX_GROUPS groups */
+    for (uint8_t first = 0; first < count; first = (uint8_t)(first + n)) {
+        n = (uint8_t)(count - first);
+        if (n > LSM6DSO16IS_SPIDEV_MAX_GROUPS) {
+            n = LSM6DSO16IS_SPIDEV_MAX_GROUPS;
+        }
+
+        memset(xfers, 0, 2U * n * sizeof(xfers[0]));
+        for (uint8_t i = 0; i < n; i++) {
+            cmds[i] = groups[first + i].reg | LSM6DSO16IS_SPI_READ;
+            xfers[2U * i].tx_buf = (uintptr_t)&cmds[i];
+            xfers[2U * i].len = 1;
+            xfers[(2U * i) + 1U].rx_buf = (uintptr_t)groups[first + i].data;
+            xfers[(2U * i) + 1U].len = groups[first + i].len;
+            /* Release the chip select between groups; on the last transfer
+               cs_change would keep it asserted after the message instead. */
+            xfers[(2U * i) + 1U].cs_change = (i < (n - 1U)) ? 1U : 0U;
+        }
+
+        if (transfer(xfers, 2U * n) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int32_t LSM6DSO16IS_Linux_SPI::transfer(struct spi_ioc_transfer *xfers, uint32_t count)
+{
+    uint32_t bytes = 0;
+    int ret;
+
+    if ((fd < 0) && (ioctl_fn == lsm6dso16is_spidev_ioctl)) {
+        errno = EBADF;
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        xfers[i].speed_hz = speed_hz;
+        xfers[i].bits_per_word = 8;
+        bytes += xfers[i].len;
+    }
+
+    do {
+        syscalls++;
+        ret = ioctl_fn(ioctl_ctx, fd, SPI_IOC_MESSAGE(count), xfers);
+    } while ((ret < 0) && (errno == EINTR));
+
+    /* SPI_IOC_MESSAGE returns the number of bytes transferred: on a short
+       transfer errno is not set by the kernel. */
+    if ((ret >= 0) && (ret != (int)bytes)) {
+        errno = EIO;
+    }
+
+    return (ret == (int)bytes) ? 0 : 1;
+}
+
+#endif // LSM6DSO16IS_HOST_BUILD && __linux__
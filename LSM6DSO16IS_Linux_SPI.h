@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_LINUX_SPI_H
+#define LSM6DSO16IS_LINUX_SPI_H
+
+#include "LSM6DSO16IS.h"
+
+#if defined(LSM6DSO16IS_HOST_BUILD) && defined(__linux__)
+#include <linux/spi/spidev.h>
+
+#define LSM6DSO16IS_SPIDEV_SPEED_HZ      10000000U
+/* Each group is a command byte transfer plus a data transfer */
+#define LSM6DSO16IS_SPIDEV_MAX_GROUPS    16U
+
+/*
+ * Linux userspace SPI transport over /dev/spidevB.C, in SPI mode 3. Every
+ * register access is one SPI_IOC_MESSAGE ioctl made of a command byte transfer
+ * and a data transfer under the same chip select. read_groups() puts up to
+ * LSM6DSO16IS_SPIDEV_MAX_GROUPS such pairs in one message, releasing the chip
+ * select between groups with cs_change, so status, outputs and timestamp of a
+ * sample cost one system call; larger batches are split into several messages.
+ * A failed access returns non-zero with errno set, interrupted ioctls are
+ * restarted.
+ */
+class LSM6DSO16IS_Linux_SPI : public LSM6DSO16IS_Bus {
+public:
+    LSM6DSO16IS_Linux_SPI();
+    ~LSM6DSO16IS_Linux_SPI();
+
+    LSM6DSO16ISStatusTypeDef Open(const char *Device, uint32_t Speed_Hz = LSM6DSO16IS_SPIDEV_SPEED_HZ);
+    void Close(void);
+    void Set_Ioctl(LSM6DSO16IS_Ioctl_t Ioctl, void *Ctx);
+    uint32_t Get_Syscalls(void) const { return syscalls; }
+
+    int32_t read(uint8_t reg, uint8_t *data, uint16_t len) override;
+    int32_t write(uint8_t reg, const uint8_t *data, uint16_t len) override;
+    int32_t read_groups(const LSM6DSO16IS_Read_Group_t *groups, uint8_t count) override;
+
+private:
+    int32_t transfer(struct spi_ioc_transfer *xfers, uint32_t count);
+
+    int fd;
+    uint32_t speed_hz;
+    LSM6DSO16IS_Ioctl_t ioctl_fn;
+    void *ioctl_ctx;
+    uint32_t syscalls;
+};
+
+#endif // LSM6DSO16IS_HOST_BUILD && __linux__
+
+#endif // LSM6DSO16IS_LINUX_SPI_H
@@ -0,0 +1,243 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_ODR_Governor.h"
+
+/**
+  * @brief  Build a governor over a table of levels
+  * @note   With no levels (count 0 or levels NULL) every call fails. Levels
+  *         beyond LSM6DSO16IS_GOVERNOR_MAX_LEVELS are ignored
+  * @param  sensor driver instance whose accelerometer ODR is governed
+  * @param  levels operating points, from the slowest to the fastest
+  * @param  count number of levels
+  * @param  min_dwell_ms minimum time in a level before the next step
+  * @param  window samples per variance window of Update_Sample(), 0 means 1
+  */
+LSM6DSO16IS_ODR_Governor::LSM6DSO16IS_ODR_Governor(LSM6DSO16IS *sensor, const LSM6DSO16IS_Governor_Level_t *levels,
+                                                   uint8_t count, uint32_t min_dwell_ms, uint16_t window)
+{
+    this->sensor = sensor;
+    this->count = (count > LSM6DSO16IS_GOVERNOR_MAX_LEVELS) ? LSM6DSO16IS_GOVERNOR_MAX_LEVELS : count;
+    this->levels = (this->count != 0U) ? levels : NULL;
+    if (this->levels == NULL) {
+        this->count = 0;
+    }
+    this->min_dwell_ms = min_dwell_ms;
+    this->window = (window == 0U) ? 1U : window;
+
+    level = 0;
+    dwell_us = 0;
+    dwell_ms = 0;
+    samples = 0;
+    for (uint8_t i = 0; i < 3U; i++) {
+        sum[i] = 0;
+        sum_sq[i] = 0;
+    }
+    Reset_Stats();
+}
+
+/**
+  * @brief  Apply the initial level and start accounting
+  * @param  level index of the initial level
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Start(uint8_t level)
+{
+    if (level >= count) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    last_account_us = lsm6dso16is_time_us();
+    return apply_level(level);
+}
+
+/**
+  * @brief  Read one accelerometer sample and feed it to the governor
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Poll(void)
+{
+    int32_t raw[3];
+
+    if (sensor->Get_X_AxesRaw(raw) != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    return Update_Sample(raw);
+}
+
+/**
+  * @brief  Feed an accelerometer sample already read by the application
+  * @note   The variance is accumulated in integers and evaluated once per window
+  * @param  Raw the raw values of the three axes
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Update_Sample(const int32_t *Raw)
+{
+    uint32_t activity = 0;
+    int64_t var;
+
+    if (levels == NULL) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        sum[i] += Raw[i];
+        sum_sq[i] += (int64_t)Raw[i] * Raw[i];
+    }
+
+    if (++samples < window) {
+        return LSM6DSO16IS_STATUS_OK;
+    }
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        var = (sum_sq[i] - ((sum[i] * sum[i]) / samples)) / samples;
+        activity += (var > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)var;
+        sum[i] = 0;
+        sum_sq[i] = 0;
+    }
+    samples = 0;
+
+    return Update_Activity(activity);
+}
+
+/**
+  * @brief  Feed an activity flag computed by the ISPU
+  * @param  Active 1 if the ISPU reports motion
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Update_ISPU_Flag(uint8_t Active)
+{
+    return Update_Activity((Active != 0U) ? UINT32_MAX : 0U);
+}
+
+/**
+  * @brief  Step the level according to an activity measure
+  * @note   The dwell time is accumulated in ms between calls, so it does not
+  *         wrap with the microsecond clock
+  * @param  Activity activity measure, compared with the level thresholds
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Update_Activity(uint32_t Activity)
+{
+    const LSM6DSO16IS_Governor_Level_t *current;
+
+    if (levels == NULL) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+    current = &levels[level];
+
+    account();
+
+    if (dwell_ms < min_dwell_ms) {
+        return LSM6DSO16IS_STATUS_OK;
+    }
+
+    if ((Activity > current->up_threshold) && ((level + 1U) < count)) {
+        return apply_level(level + 1U);
+    }
+    if ((Activity < current->down_threshold) && (level > 0U)) {
+        return apply_level(level - 1U);
+    }
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+/**
+  * @brief  Get the time spent in each level and the transactions saved
+  * @param  Stats pointer where the statistics are written
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::Get_Stats(LSM6DSO16IS_Governor_Stats_t *Stats)
+{
+    if (levels == NULL) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    account();
+
+    Stats->level = level;
+    Stats->transitions = transitions;
+    for (uint8_t i = 0; i < LSM6DSO16IS_GOVERNOR_MAX_LEVELS; i++) {
+        Stats->time_in_level_ms[i] = time_in_level_ms[i];
+    }
+    Stats->transactions_saved = (uint32_t)(saved_dhz_us / 10000000U);
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+void LSM6DSO16IS_ODR_Governor::Reset_Stats(void)
+{
+    for (uint8_t i = 0; i < LSM6DSO16IS_GOVERNOR_MAX_LEVELS; i++) {
+        time_in_level_us[i] = 0;
+        time_in_level_ms[i] = 0;
+    }
+    transitions = 0;
+    saved_dhz_us = 0;
+    last_account_us = lsm6dso16is_time_us();
+}
+
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_ODR_Governor::apply_level(uint8_t new_level)
+{
+    LSM6DSO16ISStatusTypeDef ret;
+
+    ret = sensor->Set_X_ODR_With_Mode(levels[new_level].odr, levels[new_level].mode);
+    if (ret == LSM6DSO16IS_STATUS_OK) {
+        if (new_level != level) {
+            transitions++;
+        }
+        // Il tempo fino al cambio va al livello precedente, la permanenza riparte
+        account();
+        level = new_level;
+        dwell_us = 0;
+        dwell_ms = 0;
+    }
+
+    return ret;
+}
+
+void LSM6DSO16IS_ODR_Governor::account(void)
+{
+    uint32_t now = lsm6dso16is_time_us();
+    uint32_t elapsed = now - last_account_us;
+
+    last_account_us = now;
+
+    time_in_level_us[level] += elapsed;
+    time_in_level_ms[level] += time_in_level_us[level] / 1000U;
+    time_in_level_us[level] %= 1000U;
+
+    dwell_us += elapsed;
+    if ((dwell_us / 1000U) > (UINT32_MAX - dwell_ms)) {
+        dwell_ms = UINT32_MAX;
+    } else {
+        dwell_ms += dwell_us / 1000U;
+    }
+    dwell_us %= 1000U;
+
+    /* Samples skipped, in tenths of Hz times microseconds to stay in integers. */
+    saved_dhz_us += (uint64_t)((levels[count - 1U].odr - levels[level].odr) * 10.0f) * elapsed;
+}
@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_ODR_GOVERNOR_H
+#define LSM6DSO16IS_ODR_GOVERNOR_H
+
+#include "LSM6DSO16IS.h"
+
+#define LSM6DSO16IS_GOVERNOR_MAX_LEVELS    8U
+
+/*
+ * One operating point of the governor. Levels are given from the slowest to
+ * the fastest: the governor steps up when the activity exceeds up_threshold and
+ * down when it falls below down_threshold, so down_threshold < up_threshold
+ * gives the hysteresis band.
+ */
+typedef struct {
+  float_t odr;
+  LSM6DSO16IS_Operating_Mode_t mode;
+  uint32_t up_threshold;
+  uint32_t down_threshold;
+} LSM6DSO16IS_Governor_Level_t;
+
+typedef struct {
+  uint8_t level;
+  uint32_t transitions;
+  uint32_t time_in_level_ms[LSM6DSO16IS_GOVERNOR_MAX_LEVELS];
+  uint32_t transactions_saved;
+} LSM6DSO16IS_Governor_Stats_t;
+
+/*
+ * Motion-adaptive accelerometer ODR governor. Activity is either the variance
+ * of the accelerometer samples over a window (in LSB^2, summed over the three
+ * axes) or an ISPU activity flag. Each level is kept at least min_dwell_ms
+ * before the next step. Transactions saved are counted against running the
+ * fastest level all the time, with one output read per sample.
+ */
+class LSM6DSO16IS_ODR_Governor {
+public:
+    LSM6DSO16IS_ODR_Governor(LSM6DSO16IS *sensor, const LSM6DSO16IS_Governor_Level_t *levels, uint8_t count,
+                             uint32_t min_dwell_ms, uint16_t window);
+
+    LSM6DSO16ISStatusTypeDef Start(uint8_t level);
+    LSM6DSO16ISStatusTypeDef Poll(void);
+    LSM6DSO16ISStatusTypeDef Update_Sample(const int32_t *Raw);
+    LSM6DSO16ISStatusTypeDef Update_ISPU_Flag(uint8_t Active);
+    LSM6DSO16ISStatusTypeDef Update_Activity(uint32_t Activity);
+    uint8_t Get_Level(void) const { return level; }
+    LSM6DSO16ISStatusTypeDef Get_Stats(LSM6DSO16IS_Governor_Stats_t *Stats);
+    void Reset_Stats(void);
+
+private:
+    LSM6DSO16ISStatusTypeDef apply_level(uint8_t new_level);
+    void account(void);
+
+    LSM6DSO16IS *sensor;
+    const LSM6DSO16IS_Governor_Level_t *levels;
+    uint8_t count;
+    uint8_t level;
+    uint32_t min_dwell_ms;
+    uint32_t dwell_us;
+    uint32_t dwell_ms;
+
+    // Finestra per la varianza dell'accelerometro
+    uint16_t window;
+    uint16_t samples;
+    int64_t sum[3];
+    int64_t sum_sq[3];
+
+    // Statistiche
+    uint32_t last_account_us;
+    uint32_t time_in_level_us[LSM6DSO16IS_GOVERNOR_MAX_LEVELS];
+    uint32_t time_in_level_ms[LSM6DSO16IS_GOVERNOR_MAX_LEVELS];
+    uint32_t transitions;
+    uint64_t saved_dhz_us;
+};
+
+#endif // LSM6DSO16IS_ODR_GOVERNOR_H
@@ -0,0 +1,150 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_PLATFORM_H
+#define LSM6DSO16IS_PLATFORM_H
+
+/*
+ * The driver is built against Mbed OS by default. Define LSM6DSO16IS_HOST_BUILD
+ * to build it on a Linux host, where the sensor is reached through a
+ * LSM6DSO16IS_Bus (see LSM6DSO16IS_Bus.h) instead of mbed::I2C.
+ */
+#ifdef LSM6DSO16IS_HOST_BUILD
+#include <cstdint>
+#include <cstddef>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#else
+#include "mbed.h"
+#include <cstdint>
+#endif
+
+#ifdef LSM6DSO16IS_HOST_BUILD
+/* ioctl() used by the Linux transports, replaced by a mock device on hosts without the sensor */
+typedef int (*LSM6DSO16IS_Ioctl_t)(void *ctx, int fd, unsigned long request, void *arg);
+#endif
+
+/* Monotonic time in microseconds, wraps every ~71 minutes. */
+static inline uint32_t lsm6dso16is_time_us(void)
+{
+#ifdef LSM6DSO16IS_HOST_BUILD
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return us_ticker_read();
+#endif
+}
+
+/* Monotonic time in nanoseconds, for measuring short intervals. */
+static inline uint64_t lsm6dso16is_time_ns(void)
+{
+#ifdef LSM6DSO16IS_HOST_BUILD
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return (uint64_t)us_ticker_read() * 1000U;
+#endif
+}
+
+/* Delay the calling thread: sleeps from 1 ms up, busy-waits below. */
+static inline void lsm6dso16is_delay_us(uint32_t us)
+{
+#ifdef LSM6DSO16IS_HOST_BUILD
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+#else
+  if (us >= 1000U) {
+    ThisThread::sleep_for(std::chrono::milliseconds(us / 1000U));
+  } else {
+    wait_us((int)us);
+  }
+#endif
+}
+
+/*
+ * Free-running counter for timing short sections: the DWT cycle counter on
+ * Cortex-M3 and above, the microsecond ticker on cores without it, steady_clock
+ * nanoseconds on hosts. It wraps, so only differences are meaningful.
+ */
+static inline void lsm6dso16is_cycles_init(void)
+{
+#if !defined(LSM6DSO16IS_HOST_BUILD) && defined(DWT_CTRL_CYCCNTENA_Msk)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static inline uint32_t lsm6dso16is_cycles(void)
+{
+#ifdef LSM6DSO16IS_HOST_BUILD
+  return (uint32_t)lsm6dso16is_time_ns();
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+  return DWT->CYCCNT;
+#else
+  return us_ticker_read();
+#endif
+}
+
+/* Frequency of lsm6dso16is_cycles() in Hz */
+static inline uint32_t lsm6dso16is_cycles_hz(void)
+{
+#ifdef LSM6DSO16IS_HOST_BUILD
+  return 1000000000U;
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+  return SystemCoreClock;
+#else
+  return 1000000U;
+#endif
+}
+
+/*
+ * Define LSM6DSO16IS_THREAD_SAFE to share one driver instance between threads.
+ * The mutex must be recursive: bank-switched sequences hold it while the
+ * single register transactions inside them take it again.
+ */
+#ifdef LSM6DSO16IS_THREAD_SAFE
+#ifdef LSM6DSO16IS_HOST_BUILD
+#include <mutex>
+typedef std::recursive_mutex lsm6dso16is_mutex_t;
+#else
+typedef rtos::Mutex lsm6dso16is_mutex_t; /* rtos::Mutex is recursive */
+#endif
+#endif
+
+/*
+ * Define LSM6DSO16IS_BUS_STATS to count the bus transactions, bytes and bus
+ * time of each public call (see LSM6DSO16IS::Get_Bus_Stats()). Without it the
+ * accounting compiles to nothing.
+ */
+
+/*
+ * Define LSM6DSO16IS_LATENCY_HIST to record log2 histograms of the DRDY to
+ * read start, bus transfer and conversion times (see
+ * LSM6DSO16IS::Get_Latency_Summary()). Recording is lock-free and cheap
+ * enough to stay enabled in production.
+ */
+
+#endif // LSM6DSO16IS_PLATFORM_H
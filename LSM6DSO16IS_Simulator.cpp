@@ -0,0 +1,665 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Simulator.h"
+#include <string.h>
+
+#define SIM_TIMESTAMP_LSB_NS  25000U
+#define SIM_OUT_FIRST         LSM6DSO16IS_OUT_TEMP_L
+#define SIM_OUT_LAST          LSM6DSO16IS_OUTZ_H_A
+#define SIM_PAIR_TEMP         0U
+#define SIM_PAIR_G            1U
+#define SIM_PAIR_XL           4U
+#define SIM_NEVER             UINT64_MAX
+
+#define SIM_XLDA              0x01U
+#define SIM_GDA               0x02U
+#define SIM_TDA               0x04U
+
+static inline uint8_t sim_bit(uint8_t reg, uint8_t bit)
+{
+    return (uint8_t)((reg >> bit) & 0x1U);
+}
+
+/* Constructor: the model starts in the power-on state with a device at rest */
+LSM6DSO16IS_Simulator::LSM6DSO16IS_Simulator() : profile(NULL), profile_ctx(NULL), edge_cb(NULL), edge_ctx(NULL)
+{
+    memset(&motion, 0, sizeof(motion));
+    motion.acc_offset_mg[2] = 1000.0f;
+    motion.temperature_c = 25.0f;
+    transaction_ns = LSM6DSO16IS_SIM_I2C_TRANSACTION_NS;
+    byte_ns = LSM6DSO16IS_SIM_I2C_BYTE_NS;
+    real_time = 0U;
+    real_base_ns = 0U;
+    now_ns = 0U;
+    memset(ispu_program, 0, sizeof(ispu_program));
+    memset(ispu_data, 0, sizeof(ispu_data));
+    memset(&stats, 0, sizeof(stats));
+    int_level[0] = int_level[1] = 0U;
+    Reset();
+}
+
+/**
+ * @brief  Reload the power-on value of all the registers, as SW_RESET or BOOT do
+ * @note   Virtual time, statistics and the ISPU memories are preserved
+ */
+void LSM6DSO16IS_Simulator::Reset(void)
+{
+    memset(main_regs, 0, sizeof(main_regs));
+    memset(shub_regs, 0, sizeof(shub_regs));
+    memset(ispu_regs, 0, sizeof(ispu_regs));
+    main_regs[LSM6DSO16IS_WHO_AM_I] = LSM6DSO16IS_ID;
+    main_regs[LSM6DSO16IS_CTRL3_C] = 0x04U;
+    memset(bdu_locked, 0, sizeof(bdu_locked));
+    memset(bdu_pending, 0, sizeof(bdu_pending));
+    memset(bdu_value, 0, sizeof(bdu_value));
+    ispu_addr = 0U;
+    next_xl_ns = SIM_NEVER;
+    next_g_ns = SIM_NEVER;
+    boot_ns = SIM_NEVER;
+    pulse_end_ns[0] = pulse_end_ns[1] = 0U;
+    timestamp_base_ns = now_ns;
+    update_pins();
+}
+
+/**
+ * @brief  Use the built-in motion: offset plus sine on each axis
+ * @param  Motion profile, copied
+ */
+void LSM6DSO16IS_Simulator::Set_Motion(const LSM6DSO16IS_Sim_Motion_t *Motion)
+{
+    motion = *Motion;
+    profile = NULL;
+}
+
+/**
+ * @brief  Use a scripted motion, called once per generated sample
+ * @param  Profile function filling acceleration [mg], angular rate [mdps] and temperature [C]
+ * @param  Ctx passed back to Profile
+ */
+void LSM6DSO16IS_Simulator::Set_Profile(LSM6DSO16IS_Sim_Profile_t Profile, void *Ctx)
+{
+    profile = Profile;
+    profile_ctx = Ctx;
+}
+
+/**
+ * @brief  Register the callback invoked on each rising edge of INT1 or INT2
+ * @note   It runs inside the bus transaction or Advance() call that produced the edge
+ */
+void LSM6DSO16IS_Simulator::Set_Edge_Callback(LSM6DSO16IS_Sim_Edge_t Callback, void *Ctx)
+{
+    edge_cb = Callback;
+    edge_ctx = Ctx;
+}
+
+/**
+ * @brief  Set the virtual time spent by each transaction
+ * @param  Transaction_ns fixed cost (start, address, sub-address, stop)
+ * @param  Byte_ns cost of each data byte
+ */
+void LSM6DSO16IS_Simulator::Set_Bus_Timing(uint32_t Transaction_ns, uint32_t Byte_ns)
+{
+    transaction_ns = Transaction_ns;
+    byte_ns = Byte_ns;
+}
+
+/**
+ * @brief  Follow the host monotonic clock instead of the bus timing
+ * @note   Time never goes back: Advance() still adds to it
+ */
+void LSM6DSO16IS_Simulator::Set_Real_Time(uint8_t Enable)
+{
+    real_time = Enable;
+    real_base_ns = lsm6dso16is_time_ns() - now_ns;
+}
+
+/**
+ * @brief  Let the device run for the given time, producing the due samples and edges
+ */
+void LSM6DSO16IS_Simulator::Advance(uint32_t Time_us)
+{
+    if (real_time) {
+        real_base_ns -= (uint64_t)Time_us * 1000U;
+    }
+    run_until(now_ns + (uint64_t)Time_us * 1000U);
+}
+
+/**
+ * @brief  Read a register of any bank without side effects
+ */
+uint8_t LSM6DSO16IS_Simulator::Peek(lsm6dso16is_mem_bank_t Bank, uint8_t Reg) const
+{
+    const uint8_t *regs = (Bank == LSM6DSO16IS_ISPU_MEM_BANK) ? ispu_regs
+                          : (Bank == LSM6DSO16IS_SENSOR_HUB_MEM_BANK) ? shub_regs : main_regs;
+
+    return (Reg < LSM6DSO16IS_SIM_BANK_SIZE) ? regs[Reg] : 0U;
+}
+
+/**
+ * @brief  Write a register of any bank, read-only ones included, without side effects
+ * @note   This is how the ISPU outputs (DOUT) and mailbox flags are scripted
+ */
+void LSM6DSO16IS_Simulator::Poke(lsm6dso16is_mem_bank_t Bank, uint8_t Reg, uint8_t Val)
+{
+    if (Reg < LSM6DSO16IS_SIM_BANK_SIZE) {
+        bank(Bank)[Reg] = Val;
+        update_pins();
+    }
+}
+
+/**
+ * @brief  Set the ISPU interrupt status, mirrored in the main page, and update the interrupt lines
+ * @param  Status one bit per ISPU algorithm
+ */
+void LSM6DSO16IS_Simulator::Set_ISPU_Int_Status(uint32_t Status)
+{
+    for (uint8_t i = 0U; i < 4U; i++) {
+        ispu_regs[LSM6DSO16IS_ISPU_INT_STATUS0 + i] = (uint8_t)(Status >> (8U * i));
+        main_regs[LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE + i] = (uint8_t)(Status >> (8U * i));
+    }
+    update_pins();
+}
+
+/**
+ * @brief  Read a byte of the ISPU program or data memory, as loaded through ISPU_MEM_DATA
+ */
+uint8_t LSM6DSO16IS_Simulator::Get_ISPU_Memory(lsm6dso16is_ispu_mem_sel_val_t Mem, uint16_t Addr) const
+{
+    if (Mem == LSM6DSO16IS_ISPU_PROGRAM_RAM) {
+        return (Addr < LSM6DSO16IS_SIM_ISPU_PROGRAM_SIZE) ? ispu_program[Addr] : 0U;
+    }
+    return (Addr < LSM6DSO16IS_SIM_ISPU_DATA_SIZE) ? ispu_data[Addr] : 0U;
+}
+
+void LSM6DSO16IS_Simulator::Reset_Stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+int32_t LSM6DSO16IS_Simulator::read(uint8_t reg, uint8_t *data, uint16_t len)
+{
+    transaction(len);
+    stats.reads++;
+
+    for (uint16_t i = 0U; i < len; i++) {
+        data[i] = reg_read(reg);
+        if (sim_bit(main_regs[LSM6DSO16IS_CTRL3_C], 2U)) {
+            reg++;
+        }
+    }
+    update_pins();
+
+    return 0;
+}
+
+int32_t LSM6DSO16IS_Simulator::write(uint8_t reg, const uint8_t *data, uint16_t len)
+{
+    transaction(len);
+    stats.writes++;
+
+    for (uint16_t i = 0U; i < len; i++) {
+        // IF_INC e' letto ad ogni byte: una scrittura di CTRL3_C vale per i byte successivi
+        uint8_t inc = sim_bit(main_regs[LSM6DSO16IS_CTRL3_C], 2U);
+        reg_write(reg, data[i]);
+        if (inc) {
+            reg++;
+        }
+    }
+    update_pins();
+
+    return 0;
+}
+
+uint8_t *LSM6DSO16IS_Simulator::bank(lsm6dso16is_mem_bank_t b)
+{
+    return (b == LSM6DSO16IS_ISPU_MEM_BANK) ? ispu_regs
+           : (b == LSM6DSO16IS_SENSOR_HUB_MEM_BANK) ? shub_regs : main_regs;
+}
+
+lsm6dso16is_mem_bank_t LSM6DSO16IS_Simulator::current_bank(void) const
+{
+    uint8_t access = main_regs[LSM6DSO16IS_FUNC_CFG_ACCESS];
+
+    if (sim_bit(access, 7U)) {
+        return LSM6DSO16IS_ISPU_MEM_BANK;
+    }
+    return sim_bit(access, 6U) ? LSM6DSO16IS_SENSOR_HUB_MEM_BANK : LSM6DSO16IS_MAIN_MEM_BANK;
+}
+
+/* Account the transaction and move the device to the time it ends */
+void LSM6DSO16IS_Simulator::transaction(uint16_t len)
+{
+    uint64_t t = now_ns + transaction_ns + (uint64_t)byte_ns * len;
+
+    if (real_time) {
+        uint64_t host = lsm6dso16is_time_ns() - real_base_ns;
+        t = (host > now_ns) ? host : now_ns;
+    }
+    run_until(t);
+    stats.transactions++;
+    stats.bytes += len;
+}
+
+uint8_t LSM6DSO16IS_Simulator::reg_read(uint8_t reg)
+{
+    lsm6dso16is_mem_bank_t b = current_bank();
+
+    if (reg >= LSM6DSO16IS_SIM_BANK_SIZE) {
+        return 0U;
+    }
+    // FUNC_CFG_ACCESS e' lo stesso registro in tutti i banchi
+    if (reg == LSM6DSO16IS_FUNC_CFG_ACCESS) {
+        return main_regs[reg];
+    }
+    if (b == LSM6DSO16IS_SENSOR_HUB_MEM_BANK) {
+        return shub_regs[reg];
+    }
+
+    if (b == LSM6DSO16IS_ISPU_MEM_BANK) {
+        uint8_t sel = ispu_regs[LSM6DSO16IS_ISPU_MEM_SEL];
+        if (reg != LSM6DSO16IS_ISPU_MEM_DATA || !sim_bit(sel, 6U)) {
+            return ispu_regs[reg];
+        }
+        // Lettura della memoria selezionata con incremento dell'indirizzo
+        uint8_t val = Get_ISPU_Memory(sim_bit(sel, 0U) ? LSM6DSO16IS_ISPU_PROGRAM_RAM : LSM6DSO16IS_ISPU_DATA_RAM,
+                                      ispu_addr);
+        ispu_addr++;
+        return val;
+    }
+
+    if (reg >= LSM6DSO16IS_TIMESTAMP0 && reg <= LSM6DSO16IS_TIMESTAMP3) {
+        uint32_t ts = (uint32_t)((now_ns - timestamp_base_ns) / SIM_TIMESTAMP_LSB_NS);
+        if (!sim_bit(main_regs[LSM6DSO16IS_CTRL10_C], 5U)) {
+            ts = (uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP0] | ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP1] << 8) |
+                 ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP2] << 16) | ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP3] << 24);
+        }
+        return (uint8_t)(ts >> (8U * (reg - LSM6DSO16IS_TIMESTAMP0)));
+    }
+
+    if (reg >= SIM_OUT_FIRST && reg <= SIM_OUT_LAST) {
+        uint8_t pair = (uint8_t)((reg - SIM_OUT_FIRST) / 2U);
+        uint8_t val = main_regs[reg];
+        if (((reg - SIM_OUT_FIRST) & 0x1U) == 0U) {
+            // Parte bassa: con BDU la coppia resta ferma fino alla lettura della parte alta
+            bdu_locked[pair] = sim_bit(main_regs[LSM6DSO16IS_CTRL3_C], 6U);
+        } else {
+            main_regs[LSM6DSO16IS_STATUS_REG] &= (uint8_t)~((pair == SIM_PAIR_TEMP) ? SIM_TDA
+                                                            : (pair < SIM_PAIR_XL) ? SIM_GDA : SIM_XLDA);
+            bdu_locked[pair] = 0U;
+            if (bdu_pending[pair]) {
+                bdu_pending[pair] = 0U;
+                output_set(pair, bdu_value[pair]);
+            }
+        }
+        return val;
+    }
+
+    return main_regs[reg];
+}
+
+void LSM6DSO16IS_Simulator::reg_write(uint8_t reg, uint8_t val)
+{
+    if (reg >= LSM6DSO16IS_SIM_BANK_SIZE) {
+        return;
+    }
+    if (reg == LSM6DSO16IS_FUNC_CFG_ACCESS) {
+        lsm6dso16is_mem_bank_t old = current_bank();
+        main_regs[reg] = val & 0xC0U;
+        if (sim_bit(val, 1U)) {
+            // SW_RESET_ISPU: l'ISPU torna in reset
+            memset(ispu_regs, 0, sizeof(ispu_regs));
+            boot_ns = SIM_NEVER;
+        }
+        if (current_bank() != old) {
+            stats.bank_switches++;
+        }
+        return;
+    }
+
+    switch (current_bank()) {
+        case LSM6DSO16IS_ISPU_MEM_BANK:
+            ispu_write(reg, val);
+            break;
+        case LSM6DSO16IS_SENSOR_HUB_MEM_BANK:
+            shub_regs[reg] = val;
+            break;
+        default:
+            main_write(reg, val);
+            break;
+    }
+}
+
+void LSM6DSO16IS_Simulator::main_write(uint8_t reg, uint8_t val)
+{
+    switch (reg) {
+        case LSM6DSO16IS_WHO_AM_I:
+        case LSM6DSO16IS_ISPU_INT_STATUS0_MAINPAGE:
+        case LSM6DSO16IS_ISPU_INT_STATUS1_MAINPAGE:
+        case LSM6DSO16IS_ISPU_INT_STATUS2_MAINPAGE:
+        case LSM6DSO16IS_ISPU_INT_STATUS3_MAINPAGE:
+        case LSM6DSO16IS_STATUS_REG:
+        case LSM6DSO16IS_TIMESTAMP0:
+        case LSM6DSO16IS_TIMESTAMP1:
+        case LSM6DSO16IS_TIMESTAMP3:
+            return;
+        case LSM6DSO16IS_TIMESTAMP2:
+            // 0xAA azzera il contatore
+            if (val == 0xAAU) {
+                timestamp_base_ns = now_ns;
+                main_regs[LSM6DSO16IS_TIMESTAMP0] = main_regs[LSM6DSO16IS_TIMESTAMP1] = 0U;
+                main_regs[LSM6DSO16IS_TIMESTAMP2] = main_regs[LSM6DSO16IS_TIMESTAMP3] = 0U;
+            }
+            return;
+        case LSM6DSO16IS_CTRL3_C:
+            if ((val & 0x81U) != 0U) {
+                // SW_RESET e BOOT si azzerano da soli dopo aver ricaricato i valori di default
+                Reset();
+                return;
+            }
+            break;
+        case LSM6DSO16IS_CTRL10_C:
+            if (sim_bit(val, 5U) != sim_bit(main_regs[reg], 5U)) {
+                uint32_t ts = (uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP0] | ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP1] << 8) |
+                              ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP2] << 16) |
+                              ((uint32_t)main_regs[LSM6DSO16IS_TIMESTAMP3] << 24);
+                if (sim_bit(val, 5U)) {
+                    // Riprende a contare dal valore congelato
+                    timestamp_base_ns = now_ns - (uint64_t)ts * SIM_TIMESTAMP_LSB_NS;
+                } else {
+                    ts = (uint32_t)((now_ns - timestamp_base_ns) / SIM_TIMESTAMP_LSB_NS);
+                    for (uint8_t i = 0U; i < 4U; i++) {
+                        main_regs[LSM6DSO16IS_TIMESTAMP0 + i] = (uint8_t)(ts >> (8U * i));
+                    }
+                }
+            }
+            break;
+        default:
+            if (reg >= SIM_OUT_FIRST && reg <= SIM_OUT_LAST) {
+                return;
+            }
+            break;
+    }
+
+    main_regs[reg] = val;
+
+    if (reg == LSM6DSO16IS_CTRL1_XL || reg == LSM6DSO16IS_CTRL6_C) {
+        schedule_xl();
+    } else if (reg == LSM6DSO16IS_CTRL2_G || reg == LSM6DSO16IS_CTRL7_G || reg == LSM6DSO16IS_CTRL4_C) {
+        schedule_g();
+    }
+}
+
+void LSM6DSO16IS_Simulator::ispu_write(uint8_t reg, uint8_t val)
+{
+    if (reg == LSM6DSO16IS_ISPU_STATUS ||
+        (reg >= LSM6DSO16IS_ISPU_DOUT_00_L && reg <= LSM6DSO16IS_ISPU_DOUT_31_H) ||
+        (reg >= LSM6DSO16IS_ISPU_INT_STATUS0 && reg <= LSM6DSO16IS_ISPU_INT_STATUS3)) {
+        return;
+    }
+
+    switch (reg) {
+        case LSM6DSO16IS_ISPU_CONFIG:
+            if (sim_bit(val, 0U) && !sim_bit(ispu_regs[reg], 0U)) {
+                // Uscita dal reset: BOOT_END dopo il caricamento
+                boot_ns = now_ns + (uint64_t)LSM6DSO16IS_SIM_ISPU_BOOT_US * 1000U;
+            } else if (!sim_bit(val, 0U)) {
+                ispu_regs[LSM6DSO16IS_ISPU_STATUS] &= (uint8_t)~0x04U;
+                boot_ns = SIM_NEVER;
+            }
+            break;
+        case LSM6DSO16IS_ISPU_MEM_ADDR1:
+            ispu_addr = (uint16_t)((ispu_addr & 0x00FFU) | ((uint16_t)val << 8));
+            break;
+        case LSM6DSO16IS_ISPU_MEM_ADDR0:
+            ispu_addr = (uint16_t)((ispu_addr & 0xFF00U) | val);
+            break;
+        case LSM6DSO16IS_ISPU_MEM_DATA: {
+            uint8_t sel = ispu_regs[LSM6DSO16IS_ISPU_MEM_SEL];
+            if (sim_bit(sel, 0U) && ispu_addr < LSM6DSO16IS_SIM_ISPU_PROGRAM_SIZE) {
+                ispu_program[ispu_addr] = val;
+            } else if (!sim_bit(sel, 0U) && ispu_addr < LSM6DSO16IS_SIM_ISPU_DATA_SIZE) {
+                ispu_data[ispu_addr] = val;
+            }
+            ispu_addr++;
+            break;
+        }
+        case LSM6DSO16IS_ISPU_IF2S_FLAG_L:
+        case LSM6DSO16IS_ISPU_IF2S_FLAG_H:
+            // I flag vengono azzerati dall'ISPU, non dall'interfaccia
+            val |= ispu_regs[reg];
+            break;
+        default:
+            break;
+    }
+
+    ispu_regs[reg] = val;
+}
+
+/* Schedule the next accelerometer sample from CTRL1_XL.ODR and CTRL6_C.XL_HM_MODE */
+void LSM6DSO16IS_Simulator::schedule_xl(void)
+{
+    uint8_t code = (uint8_t)((main_regs[LSM6DSO16IS_CTRL1_XL] >> 4) |
+                             (sim_bit(main_regs[LSM6DSO16IS_CTRL6_C], 4U) << 4));
+    float_t odr = ((code & 0xFU) == 0U) ? -1.0f : lsm6dso16is_xl_odr_hz(code);
+
+    next_xl_ns = (odr > 0.0f) ? now_ns + (uint64_t)(1e9f / odr) : SIM_NEVER;
+}
+
+/* Schedule the next gyroscope sample from CTRL2_G.ODR, CTRL7_G.G_HM_MODE and CTRL4_C.SLEEP_G */
+void LSM6DSO16IS_Simulator::schedule_g(void)
+{
+    uint8_t code = (uint8_t)((main_regs[LSM6DSO16IS_CTRL2_G] >> 4) |
+                             (sim_bit(main_regs[LSM6DSO16IS_CTRL7_G], 7U) << 4));
+    float_t odr = ((code & 0xFU) == 0U || sim_bit(main_regs[LSM6DSO16IS_CTRL4_C], 6U)) ? -1.0f
+                  : lsm6dso16is_gy_odr_hz(code);
+
+    next_g_ns = (odr > 0.0f) ? now_ns + (uint64_t)(1e9f / odr) : SIM_NEVER;
+}
+
+/* Process the due events in time order up to t_ns */
+void LSM6DSO16IS_Simulator::run_until(uint64_t t_ns)
+{
+    for (;;) {
+        uint64_t next = next_xl_ns;
+        if (next_g_ns < next) {
+            next = next_g_ns;
+        }
+        if (boot_ns < next) {
+            next = boot_ns;
+        }
+        for (uint8_t i = 0U; i < 2U; i++) {
+            if (pulse_end_ns[i] > now_ns && pulse_end_ns[i] < next) {
+                next = pulse_end_ns[i];
+            }
+        }
+        if (next > t_ns) {
+            break;
+        }
+
+        now_ns = next;
+        if (next_xl_ns == now_ns) {
+            sample(1U);
+            schedule_xl();
+        }
+        if (next_g_ns == now_ns) {
+            sample(0U);
+            schedule_g();
+        }
+        if (boot_ns == now_ns) {
+            ispu_regs[LSM6DSO16IS_ISPU_STATUS] |= 0x04U;
+            boot_ns = SIM_NEVER;
+        }
+        update_pins();
+    }
+
+    now_ns = t_ns;
+    update_pins();
+}
+
+/* Produce an accelerometer (xl) or gyroscope sample, with the temperature */
+void LSM6DSO16IS_Simulator::sample(uint8_t xl)
+{
+    float_t acc[3];
+    float_t gyro[3];
+    float_t temp;
+    uint64_t t_us = now_ns / 1000U;
+    uint8_t ctrl5 = main_regs[LSM6DSO16IS_CTRL5_C];
+
+    if (profile != NULL) {
+        profile(profile_ctx, t_us, acc, gyro, &temp);
+    } else {
+        float_t s = sinf(2.0f * 3.14159265f * motion.frequency_hz * ((float_t)t_us / 1e6f));
+        for (uint8_t i = 0U; i < 3U; i++) {
+            acc[i] = motion.acc_offset_mg[i] + motion.acc_amplitude_mg[i] * s;
+            gyro[i] = motion.gyro_offset_mdps[i] + motion.gyro_amplitude_mdps[i] * s;
+        }
+        temp = motion.temperature_c;
+    }
+
+    uint8_t status = main_regs[LSM6DSO16IS_STATUS_REG];
+    uint8_t flag = xl ? SIM_XLDA : SIM_GDA;
+
+    if (xl) {
+        // Autotest: ST_XL = 1 positivo, 2 negativo
+        float_t st = ((ctrl5 & 0x3U) == 1U) ? LSM6DSO16IS_SIM_XL_ST_MG
+                     : ((ctrl5 & 0x3U) == 2U) ? -LSM6DSO16IS_SIM_XL_ST_MG : 0.0f;
+        float_t sens = lsm6dso16is_xl_sensitivity[(main_regs[LSM6DSO16IS_CTRL1_XL] >> 2) & 0x3U];
+        for (uint8_t i = 0U; i < 3U; i++) {
+            output_set((uint8_t)(SIM_PAIR_XL + i), to_lsb(acc[i] + st, sens));
+        }
+        stats.xl_samples++;
+        stats.xl_overwritten += (status & SIM_XLDA) ? 1U : 0U;
+    } else {
+        // Autotest: ST_G = 1 positivo, 3 negativo
+        float_t st = (((ctrl5 >> 2) & 0x3U) == 1U) ? LSM6DSO16IS_SIM_G_ST_MDPS
+                     : (((ctrl5 >> 2) & 0x3U) == 3U) ? -LSM6DSO16IS_SIM_G_ST_MDPS : 0.0f;
+        uint8_t ctrl2 = main_regs[LSM6DSO16IS_CTRL2_G];
+        lsm6dso16is_gy_full_scale_t fs = sim_bit(ctrl2, 1U) ? LSM6DSO16IS_125dps
+                                         : (lsm6dso16is_gy_full_scale_t)((ctrl2 >> 2) & 0x3U);
+        float_t sens = lsm6dso16is_gy_sensitivity[lsm6dso16is_gy_fs_index(fs)];
+        for (uint8_t i = 0U; i < 3U; i++) {
+            output_set((uint8_t)(SIM_PAIR_G + i), to_lsb(gyro[i] + st, sens));
+        }
+        stats.g_samples++;
+        stats.g_overwritten += (status & SIM_GDA) ? 1U : 0U;
+    }
+
+    // Temperatura: 256 LSB/C, 0 LSB a 25 C
+    output_set(SIM_PAIR_TEMP, to_lsb((temp - 25.0f) * 256.0f, 1.0f));
+    main_regs[LSM6DSO16IS_STATUS_REG] = (uint8_t)(status | flag | SIM_TDA);
+
+    // DRDY impulsivo: un impulso sulle linee a cui il dato e' instradato
+    if (sim_bit(main_regs[LSM6DSO16IS_DRDY_PULSED_REG], 7U)) {
+        for (uint8_t pin = 0U; pin < 2U; pin++) {
+            if (drdy_mask((LSM6DSO16IS_SensorIntPin_t)pin) & (flag | SIM_TDA)) {
+                pulse_end_ns[pin] = now_ns + (uint64_t)LSM6DSO16IS_SIM_DRDY_PULSE_US * 1000U;
+            }
+        }
+    }
+}
+
+/* Update an output pair, or hold the value while BDU keeps it locked */
+void LSM6DSO16IS_Simulator::output_set(uint8_t pair, int16_t val)
+{
+    if (bdu_locked[pair]) {
+        bdu_pending[pair] = 1U;
+        bdu_value[pair] = val;
+        return;
+    }
+    main_regs[SIM_OUT_FIRST + 2U * pair] = (uint8_t)((uint16_t)val & 0xFFU);
+    main_regs[SIM_OUT_FIRST + 2U * pair + 1U] = (uint8_t)((uint16_t)val >> 8);
+}
+
+/* Convert to LSB, saturating at the full scale */
+int16_t LSM6DSO16IS_Simulator::to_lsb(float_t val, float_t sensitivity)
+{
+    float_t lsb = val / sensitivity;
+
+    if (lsb >= 32767.0f) {
+        return 32767;
+    }
+    if (lsb <= -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)lrintf(lsb);
+}
+
+/* STATUS_REG flags routed to a line by INT1_CTRL/INT2_CTRL */
+uint8_t LSM6DSO16IS_Simulator::drdy_mask(LSM6DSO16IS_SensorIntPin_t pin) const
+{
+    return (pin == LSM6DSO16IS_INT1_PIN) ? (main_regs[LSM6DSO16IS_INT1_CTRL] & (SIM_XLDA | SIM_GDA))
+           : (main_regs[LSM6DSO16IS_INT2_CTRL] & (SIM_XLDA | SIM_GDA | SIM_TDA));
+}
+
+uint8_t LSM6DSO16IS_Simulator::pin_level(LSM6DSO16IS_SensorIntPin_t pin) const
+{
+    uint8_t level;
+    uint8_t ispu_ctrl = (pin == LSM6DSO16IS_INT1_PIN) ? LSM6DSO16IS_ISPU_INT1_CTRL0 : LSM6DSO16IS_ISPU_INT2_CTRL0;
+    uint8_t md_cfg = (pin == LSM6DSO16IS_INT1_PIN) ? LSM6DSO16IS_MD1_CFG : LSM6DSO16IS_MD2_CFG;
+
+    if (sim_bit(main_regs[LSM6DSO16IS_DRDY_PULSED_REG], 7U)) {
+        level = (pulse_end_ns[pin] > now_ns) ? 1U : 0U;
+    } else {
+        level = (main_regs[LSM6DSO16IS_STATUS_REG] & drdy_mask(pin)) ? 1U : 0U;
+    }
+
+    // Interrupt delle ISPU abilitati in MDx_CFG
+    if (sim_bit(main_regs[md_cfg], 1U)) {
+        for (uint8_t i = 0U; i < 4U; i++) {
+            if (ispu_regs[ispu_ctrl + i] & ispu_regs[LSM6DSO16IS_ISPU_INT_STATUS0 + i]) {
+                level = 1U;
+            }
+        }
+    }
+
+    if (pin == LSM6DSO16IS_INT1_PIN) {
+        if (sim_bit(main_regs[LSM6DSO16IS_INT1_CTRL], 2U) && sim_bit(ispu_regs[LSM6DSO16IS_ISPU_STATUS], 2U)) {
+            level = 1U;
+        }
+        if (sim_bit(main_regs[LSM6DSO16IS_CTRL4_C], 5U)) {
+            level |= pin_level(LSM6DSO16IS_INT2_PIN);
+        }
+    }
+
+    return level;
+}
+
+void LSM6DSO16IS_Simulator::update_pins(void)
+{
+    for (uint8_t pin = 0U; pin < 2U; pin++) {
+        uint8_t level = pin_level((LSM6DSO16IS_SensorIntPin_t)pin);
+        if (level && !int_level[pin]) {
+            stats.int_edges[pin]++;
+            int_level[pin] = level;
+            // La callback vede gia' il nuovo livello con Get_INT()
+            if (edge_cb != NULL) {
+                edge_cb(edge_ctx, (LSM6DSO16IS_SensorIntPin_t)pin, now_ns / 1000U);
+            }
+        }
+        int_level[pin] = level;
+    }
+}
@@ -0,0 +1,175 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_SIMULATOR_H
+#define LSM6DSO16IS_SIMULATOR_H
+
+#include "LSM6DSO16IS.h"
+
+#define LSM6DSO16IS_SIM_BANK_SIZE            128U
+#define LSM6DSO16IS_SIM_ISPU_PROGRAM_SIZE    32768U
+#define LSM6DSO16IS_SIM_ISPU_DATA_SIZE       8192U
+#define LSM6DSO16IS_SIM_ISPU_BOOT_US         1000U
+#define LSM6DSO16IS_SIM_DRDY_PULSE_US        75U
+#define LSM6DSO16IS_SIM_XL_ST_MG             600.0f
+#define LSM6DSO16IS_SIM_G_ST_MDPS            300000.0f
+/* Default bus timing: I2C at 400 kHz, 9 clocks per byte, address byte and sub-address included */
+#define LSM6DSO16IS_SIM_I2C_BYTE_NS          22500U
+#define LSM6DSO16IS_SIM_I2C_TRANSACTION_NS   (2U * LSM6DSO16IS_SIM_I2C_BYTE_NS)
+
+/* Built-in motion: offset plus a sine of the given frequency on every axis */
+typedef struct {
+  float_t acc_offset_mg[3];
+  float_t acc_amplitude_mg[3];
+  float_t gyro_offset_mdps[3];
+  float_t gyro_amplitude_mdps[3];
+  float_t frequency_hz;
+  float_t temperature_c;
+} LSM6DSO16IS_Sim_Motion_t;
+
+/* Scripted motion: fills the physical values at a given time */
+typedef void (*LSM6DSO16IS_Sim_Profile_t)(void *ctx, uint64_t time_us, float_t *acc_mg, float_t *gyro_mdps,
+                                          float_t *temp_c);
+
+/* Called on each rising edge of an interrupt line */
+typedef void (*LSM6DSO16IS_Sim_Edge_t)(void *ctx, LSM6DSO16IS_SensorIntPin_t pin, uint64_t time_us);
+
+typedef struct {
+  uint32_t transactions;
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t bytes;
+  uint32_t bank_switches;
+  uint32_t xl_samples;
+  uint32_t g_samples;
+  uint32_t xl_overwritten;
+  uint32_t g_overwritten;
+  uint32_t int_edges[2];
+} LSM6DSO16IS_Sim_Stats_t;
+
+/*
+ * Register-level model of the LSM6DSO16IS, used as the LSM6DSO16IS_Bus of an
+ * unmodified driver instance on any host. Modelled:
+ * - the main, sensor hub and ISPU banks selected by FUNC_CFG_ACCESS, which is
+ *   mapped in all of them, and the read-only registers of each bank;
+ * - multi-byte accesses with or without IF_INC, and BDU: an output pair is not
+ *   updated between the read of its low and high byte;
+ * - accelerometer, gyroscope and temperature samples produced at the
+ *   configured ODR and power mode from a motion profile, converted with the
+ *   configured full scale; XLDA/GDA/TDA, gyroscope sleep and self-test;
+ * - TIMESTAMP counting at 25 us per LSB while enabled;
+ * - INT1/INT2 data-ready routing, latched or pulsed, INT2_ON_INT1 and the ISPU
+ *   boot interrupt, reported through an edge callback;
+ * - ISPU program and data memories behind ISPU_MEM_SEL/ADDR/DATA, and the
+ *   ISPU boot on ISPU_RST_N. The ISPU does not run code: its outputs,
+ *   interrupt status and mailbox flags are scripted with Poke() and
+ *   Set_ISPU_Int_Status().
+ *
+ * Time is virtual: each transaction advances it by the configured bus cost
+ * (I2C at 400 kHz by default) and Advance() moves it explicitly, so runs are
+ * deterministic; Set_Real_Time() follows the host clock instead, which the
+ * driver calls that wait on the host clock (self-test, ISPU boot timeouts
+ * with delays) need.
+ */
+class LSM6DSO16IS_Simulator : public LSM6DSO16IS_Bus {
+public:
+    LSM6DSO16IS_Simulator();
+
+    int32_t read(uint8_t reg, uint8_t *data, uint16_t len) override;
+    int32_t write(uint8_t reg, const uint8_t *data, uint16_t len) override;
+
+    void Reset(void);
+    void Set_Motion(const LSM6DSO16IS_Sim_Motion_t *Motion);
+    void Set_Profile(LSM6DSO16IS_Sim_Profile_t Profile, void *Ctx);
+    void Set_Edge_Callback(LSM6DSO16IS_Sim_Edge_t Callback, void *Ctx);
+    void Set_Bus_Timing(uint32_t Transaction_ns, uint32_t Byte_ns);
+    void Set_Real_Time(uint8_t Enable);
+    void Advance(uint32_t Time_us);
+    uint64_t Get_Time_us(void) const { return now_ns / 1000U; }
+    uint8_t Get_INT(LSM6DSO16IS_SensorIntPin_t Pin) const { return int_level[Pin]; }
+    uint8_t Peek(lsm6dso16is_mem_bank_t Bank, uint8_t Reg) const;
+    void Poke(lsm6dso16is_mem_bank_t Bank, uint8_t Reg, uint8_t Val);
+    void Set_ISPU_Int_Status(uint32_t Status);
+    uint8_t Get_ISPU_Memory(lsm6dso16is_ispu_mem_sel_val_t Mem, uint16_t Addr) const;
+    void Get_Stats(LSM6DSO16IS_Sim_Stats_t *Stats) const { *Stats = stats; }
+    void Reset_Stats(void);
+
+private:
+    uint8_t *bank(lsm6dso16is_mem_bank_t b);
+    lsm6dso16is_mem_bank_t current_bank(void) const;
+    void transaction(uint16_t len);
+    uint8_t reg_read(uint8_t reg);
+    void reg_write(uint8_t reg, uint8_t val);
+    void main_write(uint8_t reg, uint8_t val);
+    void ispu_write(uint8_t reg, uint8_t val);
+    void run_until(uint64_t t_ns);
+    void schedule_xl(void);
+    void schedule_g(void);
+    void sample(uint8_t xl);
+    void output_set(uint8_t pair, int16_t val);
+    static int16_t to_lsb(float_t val, float_t sensitivity);
+    uint8_t drdy_mask(LSM6DSO16IS_SensorIntPin_t pin) const;
+    uint8_t pin_level(LSM6DSO16IS_SensorIntPin_t pin) const;
+    void update_pins(void);
+
+    // Registri dei tre banchi
+    uint8_t main_regs[LSM6DSO16IS_SIM_BANK_SIZE];
+    uint8_t shub_regs[LSM6DSO16IS_SIM_BANK_SIZE];
+    uint8_t ispu_regs[LSM6DSO16IS_SIM_BANK_SIZE];
+
+    // Memorie dell'ISPU
+    uint8_t ispu_program[LSM6DSO16IS_SIM_ISPU_PROGRAM_SIZE];
+    uint8_t ispu_data[LSM6DSO16IS_SIM_ISPU_DATA_SIZE];
+    uint16_t ispu_addr;
+
+    // BDU: coppie di uscita (temperatura, giroscopio, accelerometro)
+    uint8_t bdu_locked[7];
+    uint8_t bdu_pending[7];
+    int16_t bdu_value[7];
+
+    // Tempo virtuale e prossimi eventi
+    uint64_t now_ns;
+    uint64_t next_xl_ns;
+    uint64_t next_g_ns;
+    uint64_t boot_ns;
+    uint64_t pulse_end_ns[2];
+    uint64_t timestamp_base_ns;
+    uint32_t transaction_ns;
+    uint32_t byte_ns;
+    uint8_t real_time;
+    uint64_t real_base_ns;
+
+    LSM6DSO16IS_Sim_Motion_t motion;
+    LSM6DSO16IS_Sim_Profile_t profile;
+    void *profile_ctx;
+    LSM6DSO16IS_Sim_Edge_t edge_cb;
+    void *edge_ctx;
+    uint8_t int_level[2];
+
+    LSM6DSO16IS_Sim_Stats_t stats;
+};
+
+#endif // LSM6DSO16IS_SIMULATOR_H
@@ -0,0 +1,262 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_Stream_Merger.h"
+
+LSM6DSO16IS_Stream_Merger::LSM6DSO16IS_Stream_Merger(LSM6DSO16IS_Merger_Sample_t *accel_buf, uint16_t accel_len,
+                                                     LSM6DSO16IS_Merger_Sample_t *gyro_buf, uint16_t gyro_len)
+{
+    rings[LSM6DSO16IS_MERGER_ACCEL].buf = accel_buf;
+    rings[LSM6DSO16IS_MERGER_ACCEL].size = accel_len;
+    rings[LSM6DSO16IS_MERGER_GYRO].buf = gyro_buf;
+    rings[LSM6DSO16IS_MERGER_GYRO].size = gyro_len;
+    reference = LSM6DSO16IS_MERGER_GYRO;
+    Reset();
+}
+
+/**
+  * @brief  Discard the pending samples and clear the statistics
+  */
+void LSM6DSO16IS_Stream_Merger::Reset(void)
+{
+    for (uint8_t i = 0; i < 2U; i++) {
+        rings[i].head = 0;
+        rings[i].count = 0;
+        stats.pushed[i] = 0;
+        stats.overruns[i] = 0;
+    }
+    stats.unaligned = 0;
+}
+
+/**
+  * @brief  Push an accelerometer sample
+  * @param  Timestamp device timestamp of the sample
+  * @param  Raw the three axes in LSB
+  * @retval 0 in case of success, an error code if the ring is full
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::Push_X(uint32_t Timestamp, const int32_t *Raw)
+{
+    return push(LSM6DSO16IS_MERGER_ACCEL, Timestamp, Raw);
+}
+
+/**
+  * @brief  Push a gyroscope sample
+  * @param  Timestamp device timestamp of the sample
+  * @param  Raw the three axes in LSB
+  * @retval 0 in case of success, an error code if the ring is full
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::Push_G(uint32_t Timestamp, const int32_t *Raw)
+{
+    return push(LSM6DSO16IS_MERGER_GYRO, Timestamp, Raw);
+}
+
+/**
+  * @brief  Read an accelerometer sample and the timestamp from the sensor and push them
+  * @note   Meant to be called from the accelerometer data-ready handler. The
+  *         timestamp and the axes are read in one Read_Reg_Groups() call.
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::Poll_X(LSM6DSO16IS *sensor)
+{
+    return poll(LSM6DSO16IS_MERGER_ACCEL, sensor, LSM6DSO16IS_OUTX_L_A);
+}
+
+/**
+  * @brief  Read a gyroscope sample and the timestamp from the sensor and push them
+  * @note   Meant to be called from the gyroscope data-ready handler. The
+  *         timestamp and the axes are read in one Read_Reg_Groups() call.
+  * @retval 0 in case of success, an error code otherwise
+  */
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::Poll_G(LSM6DSO16IS *sensor)
+{
+    return poll(LSM6DSO16IS_MERGER_GYRO, sensor, LSM6DSO16IS_OUTX_L_G);
+}
+
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::poll(LSM6DSO16IS_Merger_Source_t source, LSM6DSO16IS *sensor,
+                                                         uint8_t reg)
+{
+    uint8_t ts[4];
+    uint8_t out[6];
+    int32_t raw[3];
+    // TIMESTAMP0..3 e le uscite nello stesso gruppo di letture, senza transazioni in mezzo
+    const LSM6DSO16IS_Read_Group_t groups[2] = {
+        { LSM6DSO16IS_TIMESTAMP0, ts, sizeof(ts) },
+        { reg, out, sizeof(out) },
+    };
+
+    if (sensor->Read_Reg_Groups(groups, 2) != LSM6DSO16IS_STATUS_OK) {
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        raw[i] = (int16_t)((uint16_t)out[2U * i] | ((uint16_t)out[2U * i + 1U] << 8));
+    }
+
+    return push(source, (uint32_t)ts[0] | ((uint32_t)ts[1] << 8) | ((uint32_t)ts[2] << 16) | ((uint32_t)ts[3] << 24),
+                raw);
+}
+
+/**
+  * @brief  Read the samples of both sensors in time order
+  * @note   A sample is released only once the other sensor has a pending
+  *         sample, so that a later push cannot produce an older timestamp.
+  *         Flush releases everything that is pending, e.g. when a sensor is
+  *         stopped.
+  * @param  Out buffer for the samples
+  * @param  Max size of Out
+  * @param  Flush release the samples even if the other sensor has none pending
+  * @retval number of samples written to Out
+  */
+uint16_t LSM6DSO16IS_Stream_Merger::Read_Interleaved(LSM6DSO16IS_Merger_Sample_t *Out, uint16_t Max, uint8_t Flush)
+{
+    uint16_t n = 0;
+
+    while (n < Max) {
+        LSM6DSO16IS_Merger_Sample_t *a = peek(LSM6DSO16IS_MERGER_ACCEL, 0);
+        LSM6DSO16IS_Merger_Sample_t *g = peek(LSM6DSO16IS_MERGER_GYRO, 0);
+        LSM6DSO16IS_Merger_Source_t source;
+
+        if ((a != NULL) && (g != NULL)) {
+            source = before(g->timestamp, a->timestamp) ? LSM6DSO16IS_MERGER_GYRO : LSM6DSO16IS_MERGER_ACCEL;
+        } else if ((Flush != 0U) && (a != NULL)) {
+            source = LSM6DSO16IS_MERGER_ACCEL;
+        } else if ((Flush != 0U) && (g != NULL)) {
+            source = LSM6DSO16IS_MERGER_GYRO;
+        } else {
+            break;
+        }
+
+        Out[n++] = *peek(source, 0);
+        drop(source);
+    }
+
+    return n;
+}
+
+/**
+  * @brief  Read frames aligned on the timestamps of the reference sensor
+  * @note   The other sensor is linearly interpolated between the two samples
+  *         that bracket each reference timestamp; the reference should be the
+  *         faster sensor (see Set_Reference()). Reference samples older than
+  *         the first sample of the other sensor cannot be aligned and are
+  *         discarded.
+  * @param  Out buffer for the frames
+  * @param  Max size of Out
+  * @retval number of frames written to Out
+  */
+uint16_t LSM6DSO16IS_Stream_Merger::Read_Aligned(LSM6DSO16IS_Merger_Frame_t *Out, uint16_t Max)
+{
+    LSM6DSO16IS_Merger_Source_t other = (reference == LSM6DSO16IS_MERGER_ACCEL) ? LSM6DSO16IS_MERGER_GYRO
+                                                                                : LSM6DSO16IS_MERGER_ACCEL;
+    uint16_t n = 0;
+
+    while (n < Max) {
+        LSM6DSO16IS_Merger_Sample_t *r = peek(reference, 0);
+        LSM6DSO16IS_Merger_Sample_t *o0 = peek(other, 0);
+        LSM6DSO16IS_Merger_Sample_t *o1 = peek(other, 1);
+
+        if ((r == NULL) || (o0 == NULL)) {
+            break;
+        }
+
+        if (before(r->timestamp, o0->timestamp)) {
+            drop(reference);
+            stats.unaligned++;
+            continue;
+        }
+
+        if (o1 == NULL) {
+            break;
+        }
+
+        /* Keep the pair (o0, o1) that brackets the reference timestamp. */
+        if (before(o1->timestamp, r->timestamp)) {
+            drop(other);
+            continue;
+        }
+
+        int32_t *ref = (reference == LSM6DSO16IS_MERGER_ACCEL) ? Out[n].accel : Out[n].gyro;
+        int32_t *interp = (reference == LSM6DSO16IS_MERGER_ACCEL) ? Out[n].gyro : Out[n].accel;
+        int64_t span = (int64_t)(uint32_t)(o1->timestamp - o0->timestamp);
+        int64_t offset = (int64_t)(uint32_t)(r->timestamp - o0->timestamp);
+
+        Out[n].timestamp = r->timestamp;
+        for (uint8_t i = 0; i < 3U; i++) {
+            ref[i] = r->axes[i];
+            if (span == 0) {
+                interp[i] = o1->axes[i];
+            } else {
+                interp[i] = (int32_t)(o0->axes[i] + (((int64_t)(o1->axes[i] - o0->axes[i]) * offset) / span));
+            }
+        }
+        n++;
+        drop(reference);
+    }
+
+    return n;
+}
+
+LSM6DSO16ISStatusTypeDef LSM6DSO16IS_Stream_Merger::push(LSM6DSO16IS_Merger_Source_t source, uint32_t timestamp,
+                                                         const int32_t *raw)
+{
+    ring_t *ring = &rings[source];
+    LSM6DSO16IS_Merger_Sample_t *sample;
+
+    if (ring->count >= ring->size) {
+        stats.overruns[source]++;
+        return LSM6DSO16IS_STATUS_ERROR;
+    }
+
+    sample = &ring->buf[(ring->head + ring->count) % ring->size];
+    sample->timestamp = timestamp;
+    sample->source = source;
+    sample->axes[0] = raw[0];
+    sample->axes[1] = raw[1];
+    sample->axes[2] = raw[2];
+    ring->count++;
+    stats.pushed[source]++;
+
+    return LSM6DSO16IS_STATUS_OK;
+}
+
+LSM6DSO16IS_Merger_Sample_t *LSM6DSO16IS_Stream_Merger::peek(LSM6DSO16IS_Merger_Source_t source, uint16_t index)
+{
+    ring_t *ring = &rings[source];
+
+    if (index >= ring->count) {
+        return NULL;
+    }
+
+    return &ring->buf[(ring->head + index) % ring->size];
+}
+
+void LSM6DSO16IS_Stream_Merger::drop(LSM6DSO16IS_Merger_Source_t source)
+{
+    ring_t *ring = &rings[source];
+
+    ring->head = (uint16_t)((ring->head + 1U) % ring->size);
+    ring->count--;
+}
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_STREAM_MERGER_H
+#define LSM6DSO16IS_STREAM_MERGER_H
+
+#include "LSM6DSO16IS.h"
+
+typedef enum {
+  LSM6DSO16IS_MERGER_ACCEL = 0,
+  LSM6DSO16IS_MERGER_GYRO = 1,
+} LSM6DSO16IS_Merger_Source_t;
+
+/* One sample of a single sensor, raw LSB, with its device timestamp */
+typedef struct {
+  uint32_t timestamp;
+  LSM6DSO16IS_Merger_Source_t source;
+  int32_t axes[3];
+} LSM6DSO16IS_Merger_Sample_t;
+
+/* One aligned frame: both sensors at the timestamp of the reference sensor */
+typedef struct {
+  uint32_t timestamp;
+  int32_t accel[3];
+  int32_t gyro[3];
+} LSM6DSO16IS_Merger_Frame_t;
+
+typedef struct {
+  uint32_t pushed[2];
+  uint32_t overruns[2];
+  uint32_t unaligned;
+} LSM6DSO16IS_Merger_Stats_t;
+
+/*
+ * Merger of the independently clocked accelerometer and gyroscope streams.
+ * Samples are pushed with their device timestamp (see Get_Timestamp()) into
+ * two rings allocated by the caller, then read back either interleaved in time
+ * order or aligned on the timestamps of a reference sensor, the other sensor
+ * being linearly interpolated. Timestamps may wrap around 32 bits. No memory is
+ * allocated after construction.
+ *
+ * The merger is not synchronised: Push_X()/Push_G()/Poll_X()/Poll_G() and the
+ * Read_*() calls must all run in the same context (e.g. one EventQueue
+ * thread), never from an ISR concurrently with a read.
+ */
+class LSM6DSO16IS_Stream_Merger {
+public:
+    LSM6DSO16IS_Stream_Merger(LSM6DSO16IS_Merger_Sample_t *accel_buf, uint16_t accel_len,
+                              LSM6DSO16IS_Merger_Sample_t *gyro_buf, uint16_t gyro_len);
+
+    LSM6DSO16ISStatusTypeDef Push_X(uint32_t Timestamp, const int32_t *Raw);
+    LSM6DSO16ISStatusTypeDef Push_G(uint32_t Timestamp, const int32_t *Raw);
+    LSM6DSO16ISStatusTypeDef Poll_X(LSM6DSO16IS *sensor);
+    LSM6DSO16ISStatusTypeDef Poll_G(LSM6DSO16IS *sensor);
+    uint16_t Read_Interleaved(LSM6DSO16IS_Merger_Sample_t *Out, uint16_t Max, uint8_t Flush);
+    void Set_Reference(LSM6DSO16IS_Merger_Source_t Source) { reference = Source; }
+    uint16_t Read_Aligned(LSM6DSO16IS_Merger_Frame_t *Out, uint16_t Max);
+    uint16_t Get_Pending(LSM6DSO16IS_Merger_Source_t Source) const { return rings[Source].count; }
+    void Get_Stats(LSM6DSO16IS_Merger_Stats_t *Stats) const { *Stats = stats; }
+    void Reset(void);
+
+private:
+    typedef struct {
+      LSM6DSO16IS_Merger_Sample_t *buf;
+      uint16_t size;
+      uint16_t head;
+      uint16_t count;
+    } ring_t;
+
+    LSM6DSO16ISStatusTypeDef push(LSM6DSO16IS_Merger_Source_t source, uint32_t timestamp, const int32_t *raw);
+    LSM6DSO16ISStatusTypeDef poll(LSM6DSO16IS_Merger_Source_t source, LSM6DSO16IS *sensor, uint8_t reg);
+    LSM6DSO16IS_Merger_Sample_t *peek(LSM6DSO16IS_Merger_Source_t source, uint16_t index);
+    void drop(LSM6DSO16IS_Merger_Source_t source);
+    static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+    ring_t rings[2];
+    LSM6DSO16IS_Merger_Source_t reference;
+    LSM6DSO16IS_Merger_Stats_t stats;
+};
+
+#endif // LSM6DSO16IS_STREAM_MERGER_H
@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_TABLES_H
+#define LSM6DSO16IS_TABLES_H
+
+#include "registers.h"
+
+/*
+ * Compile-time tables shared by the accelerometer and the gyroscope: output
+ * data rates by ODR field value, full scales and sensitivities by FS field
+ * value. The lookup functions are constexpr, so requests made with constant
+ * arguments are resolved by the compiler; the _const variants are consteval
+ * when built as C++20 and reject non-constant arguments.
+ */
+#if defined(__cpp_consteval)
+#define LSM6DSO16IS_CONSTEVAL consteval
+#else
+#define LSM6DSO16IS_CONSTEVAL constexpr
+#endif
+
+#define LSM6DSO16IS_ODR_CODES      12U
+#define LSM6DSO16IS_ODR_LP_FLAG    0x10U
+#define LSM6DSO16IS_ODR_1HZ6       0xbU
+
+/* ODR field (CTRL1_XL.odr_xl / CTRL2_G.odr_g) to Hz; 0xb is 1.6 Hz, accelerometer low power only */
+static constexpr float_t lsm6dso16is_odr_hz[LSM6DSO16IS_ODR_CODES] = {
+  0.0f, 12.5f, 26.0f, 52.0f, 104.0f, 208.0f, 416.0f, 833.0f, 1667.0f, 3333.0f, 6667.0f, 1.6f
+};
+
+/* CTRL1_XL.fs_xl to full scale in g and sensitivity in mg/LSB */
+static constexpr int32_t lsm6dso16is_xl_fs_g[4] = { 2, 16, 4, 8 };
+static constexpr float_t lsm6dso16is_xl_sensitivity[4] = {
+  LSM6DSO16IS_ACC_SENSITIVITY_FS_2G, LSM6DSO16IS_ACC_SENSITIVITY_FS_16G,
+  LSM6DSO16IS_ACC_SENSITIVITY_FS_4G, LSM6DSO16IS_ACC_SENSITIVITY_FS_8G
+};
+
+/* CTRL2_G.fs_g to full scale in dps and sensitivity in mdps/LSB, index 4 when fs_125 is set */
+static constexpr int32_t lsm6dso16is_gy_fs_dps[5] = { 250, 500, 1000, 2000, 125 };
+static constexpr float_t lsm6dso16is_gy_sensitivity[5] = {
+  LSM6DSO16IS_GYRO_SENSITIVITY_FS_250DPS, LSM6DSO16IS_GYRO_SENSITIVITY_FS_500DPS,
+  LSM6DSO16IS_GYRO_SENSITIVITY_FS_1000DPS, LSM6DSO16IS_GYRO_SENSITIVITY_FS_2000DPS,
+  LSM6DSO16IS_GYRO_SENSITIVITY_FS_125DPS
+};
+
+/* Smallest ODR field value whose rate is at least Hz, the fastest one above 6667 Hz */
+static constexpr uint8_t lsm6dso16is_odr_field(float_t Hz)
+{
+  uint8_t code = 1;
+
+  while ((code < (LSM6DSO16IS_ODR_1HZ6 - 1U)) && (Hz > lsm6dso16is_odr_hz[code])) {
+    code++;
+  }
+
+  return code;
+}
+
+static constexpr lsm6dso16is_xl_data_rate_t lsm6dso16is_xl_odr_code(float_t Hz, LSM6DSO16IS_Operating_Mode_t Mode)
+{
+  return (Mode == LSM6DSO16IS_HIGH_PERFORMANCE_MODE) ? (lsm6dso16is_xl_data_rate_t)lsm6dso16is_odr_field(Hz)
+         : (Hz <= 1.6f) ? LSM6DSO16IS_XL_ODR_AT_1Hz6_LP
+         : (lsm6dso16is_xl_data_rate_t)(lsm6dso16is_odr_field(Hz) | LSM6DSO16IS_ODR_LP_FLAG);
+}
+
+static constexpr lsm6dso16is_gy_data_rate_t lsm6dso16is_gy_odr_code(float_t Hz, LSM6DSO16IS_Operating_Mode_t Mode)
+{
+  return (lsm6dso16is_gy_data_rate_t)(lsm6dso16is_odr_field(Hz) |
+                                      ((Mode == LSM6DSO16IS_LOW_POWER_MODE) ? LSM6DSO16IS_ODR_LP_FLAG : 0U));
+}
+
+/* Hz of an ODR code, -1 if the code is not valid for the sensor */
+static constexpr float_t lsm6dso16is_xl_odr_hz(uint8_t Code)
+{
+  return (((Code & 0xFU) >= LSM6DSO16IS_ODR_CODES) || (Code > (LSM6DSO16IS_ODR_LP_FLAG | 0xFU)) ||
+          ((Code & 0xFU) == LSM6DSO16IS_ODR_1HZ6 && (Code & LSM6DSO16IS_ODR_LP_FLAG) == 0U)) ? -1.0f
+         : lsm6dso16is_odr_hz[Code & 0xFU];
+}
+
+static constexpr float_t lsm6dso16is_gy_odr_hz(uint8_t Code)
+{
+  return (((Code & 0xFU) >= LSM6DSO16IS_ODR_1HZ6) || (Code > (LSM6DSO16IS_ODR_LP_FLAG | 0xFU))) ? -1.0f
+         : lsm6dso16is_odr_hz[Code & 0xFU];
+}
+
+static constexpr lsm6dso16is_xl_full_scale_t lsm6dso16is_xl_fs_code(int32_t FullScale)
+{
+  return (FullScale <= 2) ? LSM6DSO16IS_2g
+         : (FullScale <= 4) ? LSM6DSO16IS_4g
+         : (FullScale <= 8) ? LSM6DSO16IS_8g
+         :                    LSM6DSO16IS_16g;
+}
+
+static constexpr lsm6dso16is_gy_full_scale_t lsm6dso16is_gy_fs_code(int32_t FullScale)
+{
+  return (FullScale <= 125)  ? LSM6DSO16IS_125dps
+         : (FullScale <= 250)  ? LSM6DSO16IS_250dps
+         : (FullScale <= 500)  ? LSM6DSO16IS_500dps
+         : (FullScale <= 1000) ? LSM6DSO16IS_1000dps
+         :                       LSM6DSO16IS_2000dps;
+}
+
+/* Index of a gyroscope FS code in lsm6dso16is_gy_fs_dps / lsm6dso16is_gy_sensitivity */
+static constexpr uint8_t lsm6dso16is_gy_fs_index(lsm6dso16is_gy_full_scale_t Code)
+{
+  return (((uint8_t)Code & 0x10U) != 0U) ? 4U : ((uint8_t)Code & 0x3U);
+}
+
+/* Compile-time only front ends, e.g. Set_X_ODR(lsm6dso16is_xl_odr_const(104.0f)) */
+static LSM6DSO16IS_CONSTEVAL lsm6dso16is_xl_data_rate_t lsm6dso16is_xl_odr_const(
+  float_t Hz, LSM6DSO16IS_Operating_Mode_t Mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE)
+{
+  return lsm6dso16is_xl_odr_code(Hz, Mode);
+}
+
+static LSM6DSO16IS_CONSTEVAL lsm6dso16is_gy_data_rate_t lsm6dso16is_gy_odr_const(
+  float_t Hz, LSM6DSO16IS_Operating_Mode_t Mode = LSM6DSO16IS_HIGH_PERFORMANCE_MODE)
+{
+  return lsm6dso16is_gy_odr_code(Hz, Mode);
+}
+
+static_assert(lsm6dso16is_xl_odr_code(104.0f, LSM6DSO16IS_HIGH_PERFORMANCE_MODE) == LSM6DSO16IS_XL_ODR_AT_104Hz_HP,
+              "ODR table out of order");
+static_assert(lsm6dso16is_xl_odr_code(1.0f, LSM6DSO16IS_LOW_POWER_MODE) == LSM6DSO16IS_XL_ODR_AT_1Hz6_LP,
+              "ODR table out of order");
+static_assert(lsm6dso16is_gy_odr_code(7000.0f, LSM6DSO16IS_LOW_POWER_MODE) == LSM6DSO16IS_GY_ODR_AT_6667Hz_LP,
+              "ODR table out of order");
+
+#endif // LSM6DSO16IS_TABLES_H
@@ -27,7 +27,7 @@ SOFTWARE.
 #ifndef LSM6DSO16IS_REGISTERS_H
 #define LSM6DSO16IS_REGISTERS_H
 
-#include "mbed.h"
+#include "LSM6DSO16IS_Platform.h"
 
 #define LSM6DSO16IS_ACC_SENSITIVITY_FS_2G   0.061f
 #define LSM6DSO16IS_ACC_SENSITIVITY_FS_4G   0.122f
@@ -1964,6 +1964,60 @@ typedef struct {
   unsigned int ia_ispu_29 : 1;
 } LSM6DSO16IS_ISPU_Status_t;
 
+typedef enum {
+  LSM6DSO16IS_HIGH_PERFORMANCE_MODE,
+  LSM6DSO16IS_LOW_POWER_MODE,
+} LSM6DSO16IS_Operating_Mode_t;
+
+typedef enum {
+  LSM6DSO16IS_G_ACTIVE,
+  LSM6DSO16IS_G_SLEEP,
+  LSM6DSO16IS_G_POWER_DOWN,
+} LSM6DSO16IS_G_Standby_t;
+
+/*
+ * Declarative sensor configuration, compiled into the control block image
+ * DRDY_PULSED_REG..CTRL10_C by LSM6DSO16IS::Build_Config_Image().
+ */
+typedef struct {
+  float_t xl_odr;                            /* Hz, 0 for power-down */
+  int32_t xl_fs;                             /* g */
+  LSM6DSO16IS_Operating_Mode_t xl_mode;
+  float_t g_odr;                             /* Hz, 0 for power-down */
+  int32_t g_fs;                              /* dps */
+  LSM6DSO16IS_Operating_Mode_t g_mode;
+  uint8_t bdu;
+  uint8_t drdy_pulsed;
+  uint8_t int1_drdy_xl;
+  uint8_t int1_drdy_g;
+  uint8_t int2_drdy_xl;
+  uint8_t int2_drdy_g;
+  uint8_t int2_drdy_temp;
+  uint8_t int2_on_int1;
+  uint8_t timestamp;
+  uint8_t ispu_rate;                         /* CTRL9_C.ispu_rate, 0 for off */
+} LSM6DSO16IS_Config_t;
+
+/* Register image of the control block, indexed from DRDY_PULSED_REG (0x0B) to CTRL10_C (0x19) */
+typedef struct {
+  uint8_t reg[15];
+} LSM6DSO16IS_Config_Image_t;
+
+/* One entry of a queued register write list, see Write_Reg_List() */
+typedef struct {
+  uint8_t reg;
+  uint8_t value;
+} LSM6DSO16IS_Reg_Write_t;
+
+/* Self-test result: output change with positive and negative stimulus, in mg (accelerometer) or mdps (gyroscope) */
+typedef struct {
+  int32_t delta_pos[3];
+  int32_t delta_neg[3];
+  uint8_t pass_pos[3];
+  uint8_t pass_neg[3];
+  uint8_t pass;
+} LSM6DSO16IS_SelfTest_Report_t;
+
 typedef enum {
   LSM6DSO16IS_XL_ODR_OFF =                0x0,
   LSM6DSO16IS_XL_ODR_AT_12Hz5_HP =        0x1,
@@ -2043,6 +2097,15 @@ typedef struct {
   uint8_t ispu                         : 1;
 } lsm6dso16is_pin_int1_route_t;
 
+typedef struct {
+  uint8_t drdy_xl                      : 1;
+  uint8_t drdy_gy                      : 1;
+  uint8_t drdy_temp                    : 1;
+  uint8_t ispu_sleep                   : 1;
+  uint8_t ispu                         : 1;
+  uint8_t timestamp                    : 1;
+} lsm6dso16is_pin_int2_route_t;
+
 typedef enum {
   LSM6DSO16IS_GY_ST_DISABLE =             0x0,
   LSM6DSO16IS_GY_ST_POSITIVE =            0x1,
@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_I2C_Mock.h"
+#include <cerrno>
+#include <cstring>
+
+LSM6DSO16IS_I2C_Mock::LSM6DSO16IS_I2C_Mock(uint8_t address)
+{
+    memset(regs, 0, sizeof(regs));
+    regs[LSM6DSO16IS_WHO_AM_I] = LSM6DSO16IS_ID;
+    last_nmsgs = 0;
+    memset(last_flags, 0, sizeof(last_flags));
+    memset(last_len, 0, sizeof(last_len));
+    fail_count = 0;
+    fail_errno = 0;
+    this->address = address;
+    pointer = 0;
+    transfers = 0;
+    messages = 0;
+}
+
+/**
+  * @brief  ioctl() of the mock device
+  * @param  ctx the LSM6DSO16IS_I2C_Mock instance
+  * @param  fd ignored
+  * @param  request I2C_FUNCS or I2C_RDWR
+  * @param  arg the request argument
+  * @retval the number of messages for I2C_RDWR, 0 for I2C_FUNCS, -1 with errno on error
+  */
+int LSM6DSO16IS_I2C_Mock::Ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    LSM6DSO16IS_I2C_Mock *mock = (LSM6DSO16IS_I2C_Mock *)ctx;
+    struct i2c_rdwr_ioctl_data *rdwr;
+    struct i2c_msg *msg;
+
+    (void)fd;
+
+    if (request == I2C_FUNCS) {
+        *(unsigned long *)arg = I2C_FUNC_I2C;
+        return 0;
+    }
+    if (request != I2C_RDWR) {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    rdwr = (struct i2c_rdwr_ioctl_data *)arg;
+    if (rdwr->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mock->transfers++;
+    if (mock->fail_count > 0U) {
+        mock->fail_count--;
+        errno = mock->fail_errno;
+        return -1;
+    }
+
+    mock->last_nmsgs = rdwr->nmsgs;
+    for (uint32_t i = 0; i < rdwr->nmsgs; i++) {
+        msg = &rdwr->msgs[i];
+        mock->last_flags[i] = msg->flags;
+        mock->last_len[i] = msg->len;
+        if (msg->addr != mock->address) {
+            errno = ENXIO;
+            return -1;
+        }
+        mock->messages++;
+        if ((msg->flags & I2C_M_RD) != 0U) {
+            for (uint16_t j = 0; j < msg->len; j++) {
+                msg->buf[j] = mock->regs[mock->pointer++];
+            }
+        } else if (msg->len > 0U) {
+            /* First byte: register pointer, then data with auto-increment. */
+            mock->pointer = msg->buf[0];
+            for (uint16_t j = 1; j < msg->len; j++) {
+                mock->regs[mock->pointer++] = msg->buf[j];
+            }
+        }
+    }
+
+    return (int)rdwr->nmsgs;
+}
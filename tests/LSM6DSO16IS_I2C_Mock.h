@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_I2C_MOCK_H
+#define LSM6DSO16IS_I2C_MOCK_H
+
+#include "LSM6DSO16IS_Linux_I2C.h"
+
+/*
+ * Mock I2C device for host tests: answers I2C_RDWR like the sensor, with a
+ * register file and an auto-incremented register pointer. Install it with
+ * Set_Ioctl(LSM6DSO16IS_I2C_Mock::Ioctl, &mock). The messages of the last
+ * transfer are recorded, and the next Fail_Count transfers fail with
+ * Fail_Errno.
+ */
+class LSM6DSO16IS_I2C_Mock {
+public:
+    explicit LSM6DSO16IS_I2C_Mock(uint8_t address = LSM6DSO16IS_I2C_ADDRESS);
+
+    static int Ioctl(void *ctx, int fd, unsigned long request, void *arg);
+    uint32_t Get_Transfers(void) const { return transfers; }
+    uint32_t Get_Messages(void) const { return messages; }
+
+    uint8_t regs[256];
+
+    // Messaggi dell'ultimo trasferimento
+    uint32_t last_nmsgs;
+    uint16_t last_flags[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint16_t last_len[I2C_RDWR_IOCTL_MAX_MSGS];
+
+    // Errori iniettati
+    uint32_t fail_count;
+    int fail_errno;
+
+private:
+    uint16_t address;
+    uint8_t pointer;
+    uint32_t transfers;
+    uint32_t messages;
+};
+
+#endif // LSM6DSO16IS_I2C_MOCK_H
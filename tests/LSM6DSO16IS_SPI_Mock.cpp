@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LSM6DSO16IS_SPI_Mock.h"
+#include <cerrno>
+#include <cstring>
+
+LSM6DSO16IS_SPI_Mock::LSM6DSO16IS_SPI_Mock()
+{
+    memset(regs, 0, sizeof(regs));
+    regs[LSM6DSO16IS_WHO_AM_I] = LSM6DSO16IS_ID;
+    last_xfers = 0;
+    memset(last_cs_change, 0, sizeof(last_cs_change));
+    last_frames = 0;
+    memset(last_cmd, 0, sizeof(last_cmd));
+    selected = 0;
+    reading = 0;
+    pointer = 0;
+    messages = 0;
+    frames = 0;
+}
+
+/**
+  * @brief  ioctl() of the mock device
+  * @param  ctx the LSM6DSO16IS_SPI_Mock instance
+  * @param  fd ignored
+  * @param  request SPI_IOC_MESSAGE(n) or a SPI_IOC_WR_* setting
+  * @param  arg the request argument
+  * @retval the number of bytes for SPI_IOC_MESSAGE, 0 for settings, -1 with errno on error
+  */
+int LSM6DSO16IS_SPI_Mock::Ioctl(void *ctx, int fd, unsigned long request, void *arg)
+{
+    LSM6DSO16IS_SPI_Mock *mock = (LSM6DSO16IS_SPI_Mock *)ctx;
+    struct spi_ioc_transfer *xfers = (struct spi_ioc_transfer *)arg;
+    uint32_t count;
+    int bytes = 0;
+
+    (void)fd;
+
+    if ((request == SPI_IOC_WR_MODE) || (request == SPI_IOC_WR_BITS_PER_WORD) ||
+        (request == SPI_IOC_WR_MAX_SPEED_HZ)) {
+        return 0;
+    }
+    if ((_IOC_TYPE(request) != SPI_IOC_MAGIC) || (_IOC_NR(request) != 0U) ||
+        ((_IOC_SIZE(request) % sizeof(struct spi_ioc_transfer)) != 0U)) {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    count = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+    if (count > LSM6DSO16IS_SPI_MOCK_MAX_XFERS) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    mock->messages++;
+    mock->last_xfers = count;
+    mock->last_frames = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *tx = (const uint8_t *)(uintptr_t)xfers[i].tx_buf;
+        uint8_t *rx = (uint8_t *)(uintptr_t)xfers[i].rx_buf;
+
+        mock->last_cs_change[i] = xfers[i].cs_change;
+        for (uint32_t j = 0; j < xfers[i].len; j++) {
+            if (mock->selected == 0U) {
+                mock->last_cmd[mock->last_frames++] = (tx != NULL) ? tx[j] : 0U;
+            }
+            mock->byte((tx != NULL) ? tx[j] : 0U, (rx != NULL) ? &rx[j] : NULL);
+        }
+        bytes += (int)xfers[i].len;
+        if ((xfers[i].cs_change != 0U) && (i < (count - 1U))) {
+            mock->selected = 0;
+        }
+    }
+    mock->selected = 0;
+
+    return bytes;
+}
+
+void LSM6DSO16IS_SPI_Mock::byte(uint8_t tx, uint8_t *rx)
+{
+    uint8_t out = 0;
+
+    if (selected == 0U) {
+        /* First byte of a frame: command. */
+        selected = 1;
+        frames++;
+        reading = ((tx & LSM6DSO16IS_SPI_READ) != 0U) ? 1U : 0U;
+        pointer = tx & (uint8_t)~LSM6DSO16IS_SPI_READ;
+    } else if (reading != 0U) {
+        out = regs[pointer++];
+    } else {
+        regs[pointer++] = tx;
+    }
+
+    if (rx != NULL) {
+        *rx = out;
+    }
+}
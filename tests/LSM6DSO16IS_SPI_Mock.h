@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LSM6DSO16IS_SPI_MOCK_H
+#define LSM6DSO16IS_SPI_MOCK_H
+
+#include "LSM6DSO16IS_Linux_SPI.h"
+
+#define LSM6DSO16IS_SPI_MOCK_MAX_XFERS   (2U * LSM6DSO16IS_SPIDEV_MAX_GROUPS)
+
+/*
+ * Mock SPI device for host tests: answers SPI_IOC_MESSAGE like the sensor. The
+ * first byte after chip select is the command (bit 7 set for a read), then data
+ * follows with an auto-incremented register pointer. Install it with
+ * Set_Ioctl(LSM6DSO16IS_SPI_Mock::Ioctl, &mock). The transfers and the
+ * command bytes of the last message are recorded.
+ */
+class LSM6DSO16IS_SPI_Mock {
+public:
+    LSM6DSO16IS_SPI_Mock();
+
+    static int Ioctl(void *ctx, int fd, unsigned long request, void *arg);
+    uint32_t Get_Messages(void) const { return messages; }
+    uint32_t Get_Frames(void) const { return frames; }
+
+    uint8_t regs[256];
+
+    // Ultimo messaggio: cs_change di ogni trasferimento, comando di ogni frame
+    uint32_t last_xfers;
+    uint8_t last_cs_change[LSM6DSO16IS_SPI_MOCK_MAX_XFERS];
+    uint32_t last_frames;
+    uint8_t last_cmd[LSM6DSO16IS_SPI_MOCK_MAX_XFERS];
+
+private:
+    void byte(uint8_t tx, uint8_t *rx);
+
+    uint8_t selected;
+    uint8_t reading;
+    uint8_t pointer;
+    uint32_t messages;
+    uint32_t frames;
+};
+
+#endif // LSM6DSO16IS_SPI_MOCK_H
@@ -0,0 +1,110 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * Coroutine API against blocking reads, on simulated sensors whose
+ * transactions take as long as on a 400 kHz I2C bus.
+ *
+ *   async_benchmark [sensors] [rounds]
+ *
+ * Each sensor has its own bus, as on separate i2c-dev adapters: the coroutine
+ * loop must overlap their transfers, so the test fails if it is not faster
+ * than reading the sensors one after the other.
+ */
+
+#include "LSM6DSO16IS_Async.h"
+#include "LSM6DSO16IS_Simulator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/* Simulated device that holds the caller for the duration of the transfer */
+class Timed_Bus : public LSM6DSO16IS_Bus {
+public:
+    int32_t read(uint8_t reg, uint8_t *data, uint16_t len) override
+    {
+        hold(len);
+        return sim.read(reg, data, len);
+    }
+
+    int32_t write(uint8_t reg, const uint8_t *data, uint16_t len) override
+    {
+        hold(len);
+        return sim.write(reg, data, len);
+    }
+
+private:
+    static void hold(uint16_t len)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(
+            LSM6DSO16IS_SIM_I2C_TRANSACTION_NS + ((uint32_t)len * LSM6DSO16IS_SIM_I2C_BYTE_NS)));
+    }
+
+    LSM6DSO16IS_Simulator sim;
+};
+
+int main(int argc, char **argv)
+{
+    uint32_t count = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 4U;
+    uint32_t rounds = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 200U;
+    std::vector<Timed_Bus> devices(count);
+    std::vector<LSM6DSO16IS_Bus *> buses;
+    LSM6DSO16IS_Async_Benchmark_t result;
+
+    if (count == 0U) {
+        fprintf(stderr, "usage: %s [sensors] [rounds]\n", argv[0]);
+        return 2;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        buses.push_back(&devices[i]);
+    }
+
+    if (LSM6DSO16IS_Async_Benchmark(buses.data(), count, rounds, &result) != LSM6DSO16IS_STATUS_OK) {
+        fprintf(stderr, "benchmark failed\n");
+        return 1;
+    }
+
+    printf("sensors %u, rounds %u, errors %u\n", result.sensors, result.rounds, result.errors);
+    printf("blocking  %10.3f ms  %8.1f us/frame\n", (double)result.blocking_ns / 1e6,
+           (double)result.blocking_ns / 1e3 / ((double)count * rounds));
+    printf("coroutine %10.3f ms  %8.1f us/frame\n", (double)result.async_ns / 1e6,
+           (double)result.async_ns / 1e3 / ((double)count * rounds));
+    printf("speedup   %10.2f\n", (double)result.blocking_ns / (double)result.async_ns);
+
+    if (result.errors != 0U) {
+        return 1;
+    }
+    /* Con un solo sensore non c'e' nulla da sovrapporre */
+    if ((count > 1U) && (result.async_ns >= result.blocking_ns)) {
+        fprintf(stderr, "coroutine reads did not overlap\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * ISPU read path and user decoding, replayed from recorded events.
+ *
+ *   ispu_replay_benchmark [rounds]
+ *
+ * The recorded set is replayed [rounds] times through Get_ISPU_Status() and
+ * Read_ISPU_Output(); the decoder unpacks the outputs of a small ISPU
+ * algorithm (three int16 values and a frame counter). The test fails if a
+ * call fails, if the decoded values differ from the recording, or if the
+ * transactions and bank switches per event are not those of one
+ * Get_ISPU_Status() plus one Read_ISPU_Output().
+ */
+
+#include "LSM6DSO16IS_ISPU_Replay.h"
+#include "LSM6DSO16IS_Test.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/* Output of the recorded algorithm: x, y, z and frame counter, little endian */
+#define REPLAY_OUT_LEN    8U
+
+static const LSM6DSO16IS_ISPU_Record_t recorded[] = {
+    { 0x00000001U, { 0x10, 0x00, 0xF0, 0xFF, 0xE8, 0x03, 0x00, 0x00 } },
+    { 0x00000001U, { 0x12, 0x00, 0xEE, 0xFF, 0xE9, 0x03, 0x01, 0x00 } },
+    { 0x00000003U, { 0x7F, 0x01, 0x20, 0xFE, 0x00, 0x04, 0x02, 0x00 } },
+    { 0x00000001U, { 0x15, 0x00, 0xEB, 0xFF, 0xE7, 0x03, 0x03, 0x00 } },
+    { 0x00000005U, { 0x00, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x04, 0x00 } },
+    { 0x00000001U, { 0x11, 0x00, 0xEF, 0xFF, 0xE8, 0x03, 0x05, 0x00 } },
+    { 0x00000009U, { 0xA0, 0xFF, 0x60, 0x00, 0xD0, 0x03, 0x06, 0x00 } },
+    { 0x00000001U, { 0x10, 0x00, 0xF0, 0xFF, 0xE8, 0x03, 0x07, 0x00 } },
+};
+
+#define RECORDED_COUNT (sizeof(recorded) / sizeof(recorded[0]))
+
+typedef struct {
+    uint32_t events;
+    uint32_t mismatches;
+    int64_t sum[3];
+} Replay_Decode_t;
+
+static void decode(const LSM6DSO16IS_ISPU_Status_t *status, const uint8_t *dout, uint8_t len, void *ctx)
+{
+    Replay_Decode_t *d = (Replay_Decode_t *)ctx;
+    const LSM6DSO16IS_ISPU_Record_t *record = &recorded[d->events % RECORDED_COUNT];
+    uint32_t int_status;
+    uint16_t frame;
+
+    memcpy(&int_status, status, sizeof(int_status));
+    for (uint8_t i = 0; i < 3U; i++) {
+        d->sum[i] += (int16_t)((uint16_t)dout[2U * i] | ((uint16_t)dout[(2U * i) + 1U] << 8));
+    }
+    frame = (uint16_t)((uint16_t)dout[6] | ((uint16_t)dout[7] << 8));
+
+    if ((len != REPLAY_OUT_LEN) || (int_status != record->int_status) ||
+        (frame != (d->events % RECORDED_COUNT)) || (memcmp(dout, record->dout, len) != 0)) {
+        d->mismatches++;
+    }
+    d->events++;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000U;
+    std::vector<LSM6DSO16IS_ISPU_Record_t> records;
+    LSM6DSO16IS_ISPU_Bench_Report_t report;
+    LSM6DSO16IS_ISPU_Status_t status;
+    Replay_Decode_t decoded;
+    uint8_t dout[REPLAY_OUT_LEN];
+    uint32_t status_transactions;
+    uint32_t output_transactions;
+    uint32_t output_switches;
+
+    if (rounds == 0U) {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 2;
+    }
+    for (uint32_t r = 0; r < rounds; r++) {
+        records.insert(records.end(), recorded, recorded + RECORDED_COUNT);
+    }
+
+    LSM6DSO16IS_ISPU_Replay replay(records.data(), (uint32_t)records.size());
+    LSM6DSO16IS imu(&replay);
+
+    /* Costo di riferimento: una chiamata di ciascuna API su un evento */
+    TEST_CHECK(replay.Next_Event());
+    replay.Reset_Counters();
+    TEST_CHECK(imu.Get_ISPU_Status(&status) == LSM6DSO16IS_STATUS_OK);
+    status_transactions = replay.Get_Transactions();
+    TEST_CHECK(replay.Get_Bank_Switches() == 0U);
+    replay.Reset_Counters();
+    TEST_CHECK(imu.Read_ISPU_Output(LSM6DSO16IS_ISPU_DOUT_00_L, dout, sizeof(dout)) == LSM6DSO16IS_STATUS_OK);
+    output_transactions = replay.Get_Transactions();
+    output_switches = replay.Get_Bank_Switches();
+    /* Un ingresso e un'uscita dal banco ISPU */
+    TEST_CHECK(output_switches == 2U);
+
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_CHECK(replay.Run_Benchmark(&imu, LSM6DSO16IS_ISPU_DOUT_00_L, REPLAY_OUT_LEN, decode, &decoded, &report) ==
+               LSM6DSO16IS_STATUS_OK);
+
+    printf("events %u, transactions %u, bytes %u, bank switches %u\n", report.events, report.transactions,
+           report.bytes, report.bank_switches);
+    printf("per event: %.2f transactions, %.2f bytes, read %.1f ns, decode %.1f ns\n",
+           (double)report.transactions_per_event, (double)report.bytes_per_event,
+           (double)report.read_ns_per_event, (double)report.decode_ns_per_event);
+
+    TEST_CHECK(report.events == records.size());
+    TEST_CHECK(decoded.events == report.events);
+    TEST_CHECK(decoded.mismatches == 0U);
+    TEST_CHECK(report.transactions == report.events * (status_transactions + output_transactions));
+    TEST_CHECK(report.bank_switches == report.events * output_switches);
+
+    return test_failures();
+}
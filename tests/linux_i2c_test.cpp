@@ -0,0 +1,185 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * LSM6DSO16IS_Linux_I2C against the mock i2c-dev device: I2C_RDWR framing,
+ * register auto-increment through the driver and errno reporting.
+ */
+
+#include "LSM6DSO16IS_I2C_Mock.h"
+#include "LSM6DSO16IS_Test.h"
+#include <cerrno>
+
+static void test_combined_framing(void)
+{
+    LSM6DSO16IS_I2C_Mock mock;
+    LSM6DSO16IS_Linux_I2C i2c;
+    uint8_t status = 0;
+    uint8_t out[12];
+    LSM6DSO16IS_Read_Group_t groups[2] = {
+        { LSM6DSO16IS_STATUS_REG, &status, 1 },
+        { LSM6DSO16IS_OUTX_L_G, out, sizeof(out) },
+    };
+
+    i2c.Set_Ioctl(LSM6DSO16IS_I2C_Mock::Ioctl, &mock);
+    mock.regs[LSM6DSO16IS_STATUS_REG] = 0x03;
+    for (uint8_t i = 0; i < sizeof(out); i++) {
+        mock.regs[LSM6DSO16IS_OUTX_L_G + i] = (uint8_t)(0x40U + i);
+    }
+
+    /* Two sub-address writes, each followed by a read, in one ioctl */
+    TEST_CHECK(i2c.read_groups(groups, 2) == 0);
+    TEST_CHECK(i2c.Get_Syscalls() == 1U);
+    TEST_CHECK(mock.Get_Transfers() == 1U);
+    TEST_CHECK(mock.last_nmsgs == 4U);
+    TEST_CHECK(mock.last_flags[0] == 0U);
+    TEST_CHECK(mock.last_len[0] == 1U);
+    TEST_CHECK(mock.last_flags[1] == I2C_M_RD);
+    TEST_CHECK(mock.last_len[1] == 1U);
+    TEST_CHECK(mock.last_flags[2] == 0U);
+    TEST_CHECK(mock.last_len[2] == 1U);
+    TEST_CHECK(mock.last_flags[3] == I2C_M_RD);
+    TEST_CHECK(mock.last_len[3] == sizeof(out));
+    TEST_CHECK(status == 0x03U);
+    TEST_CHECK((out[0] == 0x40U) && (out[11] == 0x4BU));
+
+    /* A write is one message: sub-address then data */
+    TEST_CHECK(i2c.write(LSM6DSO16IS_CTRL1_XL, out, 2) == 0);
+    TEST_CHECK(mock.last_nmsgs == 1U);
+    TEST_CHECK(mock.last_flags[0] == 0U);
+    TEST_CHECK(mock.last_len[0] == 3U);
+}
+
+static void test_auto_increment(void)
+{
+    LSM6DSO16IS_I2C_Mock mock;
+    LSM6DSO16IS_Linux_I2C i2c;
+    LSM6DSO16IS sensor(&i2c);
+    uint8_t ctrl[3] = { 0x40, 0x4C, 0x44 };
+    uint8_t out[6];
+
+    i2c.Set_Ioctl(LSM6DSO16IS_I2C_Mock::Ioctl, &mock);
+    for (uint8_t i = 0; i < sizeof(out); i++) {
+        mock.regs[LSM6DSO16IS_OUTX_L_A + i] = (uint8_t)(0x10U + i);
+    }
+
+    /* Multi-byte accesses of the unmodified driver: one transfer each */
+    TEST_CHECK(sensor.Write_Reg(LSM6DSO16IS_CTRL1_XL, ctrl, sizeof(ctrl)) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(mock.regs[LSM6DSO16IS_CTRL1_XL] == 0x40U);
+    TEST_CHECK(mock.regs[LSM6DSO16IS_CTRL2_G] == 0x4CU);
+    TEST_CHECK(mock.regs[LSM6DSO16IS_CTRL3_C] == 0x44U);
+    TEST_CHECK(mock.Get_Transfers() == 1U);
+
+    TEST_CHECK(sensor.Read_Reg(LSM6DSO16IS_OUTX_L_A, out, sizeof(out)) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(mock.Get_Transfers() == 2U);
+    for (uint8_t i = 0; i < sizeof(out); i++) {
+        TEST_CHECK(out[i] == (uint8_t)(0x10U + i));
+    }
+}
+
+static void test_errno(void)
+{
+    LSM6DSO16IS_I2C_Mock mock;
+    LSM6DSO16IS_Linux_I2C i2c;
+    LSM6DSO16IS_Read_Group_t group = { LSM6DSO16IS_WHO_AM_I, NULL, 1 };
+    uint8_t buff[LSM6DSO16IS_MAX_WRITE_LEN + 1U];
+    uint8_t val = 0;
+
+    /* No adapter opened and no mock installed */
+    errno = 0;
+    TEST_CHECK(i2c.read(LSM6DSO16IS_WHO_AM_I, &val, 1) != 0);
+    TEST_CHECK(errno == EBADF);
+
+    i2c.Set_Ioctl(LSM6DSO16IS_I2C_Mock::Ioctl, &mock);
+
+    /* The errno of the failed ioctl reaches the caller */
+    mock.fail_count = 1;
+    mock.fail_errno = EREMOTEIO;
+    errno = 0;
+    TEST_CHECK(i2c.read(LSM6DSO16IS_WHO_AM_I, &val, 1) != 0);
+    TEST_CHECK(errno == EREMOTEIO);
+
+    /* An interrupted ioctl is restarted */
+    mock.fail_count = 1;
+    mock.fail_errno = EINTR;
+    TEST_CHECK(i2c.read(LSM6DSO16IS_WHO_AM_I, &val, 1) == 0);
+    TEST_CHECK(val == LSM6DSO16IS_ID);
+    TEST_CHECK(i2c.Get_Syscalls() == 3U);
+
+    /* Nothing to read, or a write that does not fit in one message */
+    group.data = &val;
+    errno = 0;
+    TEST_CHECK(i2c.read_groups(&group, 0) != 0);
+    TEST_CHECK(errno == EINVAL);
+    errno = 0;
+    TEST_CHECK(i2c.write(LSM6DSO16IS_CTRL1_XL, buff, sizeof(buff)) != 0);
+    TEST_CHECK(errno == EINVAL);
+}
+
+static void test_batch_split(void)
+{
+    const uint8_t count = LSM6DSO16IS_I2C_MAX_GROUPS + 4U;
+    LSM6DSO16IS_I2C_Mock mock;
+    LSM6DSO16IS_Linux_I2C i2c;
+    LSM6DSO16IS_Read_Group_t groups[count];
+    uint8_t data[count];
+
+    i2c.Set_Ioctl(LSM6DSO16IS_I2C_Mock::Ioctl, &mock);
+    for (uint8_t i = 0; i < count; i++) {
+        mock.regs[0x40U + i] = (uint8_t)(0xA0U + i);
+        groups[i].reg = (uint8_t)(0x40U + i);
+        groups[i].data = &data[i];
+        groups[i].len = 1;
+        data[i] = 0;
+    }
+
+    /* A full ioctl, then the remaining groups in a second one */
+    TEST_CHECK(i2c.read_groups(groups, count) == 0);
+    TEST_CHECK(i2c.Get_Syscalls() == 2U);
+    TEST_CHECK(mock.Get_Transfers() == 2U);
+    TEST_CHECK(mock.last_nmsgs == (2U * 4U));
+    for (uint8_t i = 0; i < count; i++) {
+        TEST_CHECK(data[i] == (uint8_t)(0xA0U + i));
+    }
+
+    /* A failed ioctl stops the batch */
+    mock.fail_count = 1;
+    mock.fail_errno = EREMOTEIO;
+    errno = 0;
+    TEST_CHECK(i2c.read_groups(groups, count) != 0);
+    TEST_CHECK(errno == EREMOTEIO);
+    TEST_CHECK(i2c.Get_Syscalls() == 3U);
+}
+
+int main(void)
+{
+    test_combined_framing();
+    test_auto_increment();
+    test_errno();
+    test_batch_split();
+
+    return test_failures();
+}
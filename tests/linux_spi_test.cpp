@@ -0,0 +1,143 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * LSM6DSO16IS_Linux_SPI against the mock spidev device: read bit of the
+ * command byte, chip select release between groups and batch splitting.
+ */
+
+#include "LSM6DSO16IS_SPI_Mock.h"
+#include "LSM6DSO16IS_Test.h"
+#include <cerrno>
+
+static void test_read_bit(void)
+{
+    LSM6DSO16IS_SPI_Mock mock;
+    LSM6DSO16IS_Linux_SPI spi;
+    LSM6DSO16IS sensor(&spi);
+    uint8_t ctrl[2] = { 0x40, 0x4C };
+    uint8_t id = 0;
+
+    spi.Set_Ioctl(LSM6DSO16IS_SPI_Mock::Ioctl, &mock);
+
+    /* Read: bit 7 of the command set, one frame for command and data */
+    TEST_CHECK(sensor.Read_Reg(LSM6DSO16IS_WHO_AM_I, &id, 1) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(id == LSM6DSO16IS_ID);
+    TEST_CHECK(mock.last_frames == 1U);
+    TEST_CHECK(mock.last_cmd[0] == (LSM6DSO16IS_WHO_AM_I | 0x80U));
+
+    /* Write: bit 7 clear, data auto-incremented in the same frame */
+    TEST_CHECK(sensor.Write_Reg(LSM6DSO16IS_CTRL1_XL, ctrl, sizeof(ctrl)) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(mock.last_frames == 1U);
+    TEST_CHECK(mock.last_cmd[0] == LSM6DSO16IS_CTRL1_XL);
+    TEST_CHECK(mock.regs[LSM6DSO16IS_CTRL1_XL] == 0x40U);
+    TEST_CHECK(mock.regs[LSM6DSO16IS_CTRL2_G] == 0x4CU);
+    TEST_CHECK(mock.Get_Messages() == 2U);
+}
+
+static void test_cs_change(void)
+{
+    LSM6DSO16IS_SPI_Mock mock;
+    LSM6DSO16IS_Linux_SPI spi;
+    uint8_t status = 0;
+    uint8_t out[12];
+    uint8_t ts[4];
+    LSM6DSO16IS_Read_Group_t groups[3] = {
+        { LSM6DSO16IS_STATUS_REG, &status, 1 },
+        { LSM6DSO16IS_OUTX_L_G, out, sizeof(out) },
+        { LSM6DSO16IS_TIMESTAMP0, ts, sizeof(ts) },
+    };
+
+    spi.Set_Ioctl(LSM6DSO16IS_SPI_Mock::Ioctl, &mock);
+    mock.regs[LSM6DSO16IS_STATUS_REG] = 0x07;
+    for (uint8_t i = 0; i < sizeof(out); i++) {
+        mock.regs[LSM6DSO16IS_OUTX_L_G + i] = (uint8_t)(0x20U + i);
+    }
+    mock.regs[LSM6DSO16IS_TIMESTAMP0] = 0x55;
+
+    /* One message; chip select released after each group but the last */
+    TEST_CHECK(spi.read_groups(groups, 3) == 0);
+    TEST_CHECK(spi.Get_Syscalls() == 1U);
+    TEST_CHECK(mock.last_xfers == 6U);
+    TEST_CHECK(mock.last_frames == 3U);
+    TEST_CHECK((mock.last_cs_change[0] == 0U) && (mock.last_cs_change[1] == 1U));
+    TEST_CHECK((mock.last_cs_change[2] == 0U) && (mock.last_cs_change[3] == 1U));
+    TEST_CHECK((mock.last_cs_change[4] == 0U) && (mock.last_cs_change[5] == 0U));
+    TEST_CHECK(mock.last_cmd[0] == (LSM6DSO16IS_STATUS_REG | 0x80U));
+    TEST_CHECK(mock.last_cmd[1] == (LSM6DSO16IS_OUTX_L_G | 0x80U));
+    TEST_CHECK(mock.last_cmd[2] == (LSM6DSO16IS_TIMESTAMP0 | 0x80U));
+    TEST_CHECK(status == 0x07U);
+    TEST_CHECK((out[0] == 0x20U) && (out[11] == 0x2BU));
+    TEST_CHECK(ts[0] == 0x55U);
+}
+
+static void test_batch_split(void)
+{
+    const uint8_t count = LSM6DSO16IS_SPIDEV_MAX_GROUPS + 4U;
+    LSM6DSO16IS_SPI_Mock mock;
+    LSM6DSO16IS_Linux_SPI spi;
+    LSM6DSO16IS_Read_Group_t groups[count];
+    uint8_t data[count];
+
+    spi.Set_Ioctl(LSM6DSO16IS_SPI_Mock::Ioctl, &mock);
+    for (uint8_t i = 0; i < count; i++) {
+        mock.regs[0x40U + i] = (uint8_t)(0xA0U + i);
+        groups[i].reg = (uint8_t)(0x40U + i);
+        groups[i].data = &data[i];
+        groups[i].len = 1;
+        data[i] = 0;
+    }
+
+    /* A full message, then the remaining groups in a second one */
+    TEST_CHECK(spi.read_groups(groups, count) == 0);
+    TEST_CHECK(spi.Get_Syscalls() == 2U);
+    TEST_CHECK(mock.Get_Messages() == 2U);
+    TEST_CHECK(mock.Get_Frames() == count);
+    TEST_CHECK(mock.last_frames == 4U);
+    TEST_CHECK(mock.last_cmd[0] == ((0x40U + LSM6DSO16IS_SPIDEV_MAX_GROUPS) | 0x80U));
+    TEST_CHECK(mock.last_cs_change[(2U * 4U) - 1U] == 0U);
+    for (uint8_t i = 0; i < count; i++) {
+        TEST_CHECK(data[i] == (uint8_t)(0xA0U + i));
+    }
+
+    /* Nothing to read, or no device */
+    errno = 0;
+    TEST_CHECK(spi.read_groups(groups, 0) != 0);
+    TEST_CHECK(errno == EINVAL);
+    spi.Set_Ioctl(NULL, NULL);
+    errno = 0;
+    TEST_CHECK(spi.read_groups(groups, 1) != 0);
+    TEST_CHECK(errno == EBADF);
+}
+
+int main(void)
+{
+    test_read_bit();
+    test_cs_change();
+    test_batch_split();
+
+    return test_failures();
+}
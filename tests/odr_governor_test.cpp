@@ -0,0 +1,211 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * LSM6DSO16IS_ODR_Governor on the device simulator: steps across the
+ * hysteresis band, the minimum dwell and the ODR written to CTRL1_XL.
+ */
+
+#include "LSM6DSO16IS_ODR_Governor.h"
+#include "LSM6DSO16IS_Simulator.h"
+#include "LSM6DSO16IS_Test.h"
+#include <chrono>
+#include <thread>
+
+/* ODR_XL codes in CTRL1_XL[7:4] */
+#define ODR_XL_12Hz5    0x1U
+#define ODR_XL_104Hz    0x4U
+#define ODR_XL_833Hz    0x7U
+#define CTRL6_C_XL_HM   0x10U
+
+static const LSM6DSO16IS_Governor_Level_t levels[] = {
+    { 12.5f, LSM6DSO16IS_LOW_POWER_MODE, 1000U, 0U },
+    { 104.0f, LSM6DSO16IS_HIGH_PERFORMANCE_MODE, 100000U, 500U },
+    { 833.0f, LSM6DSO16IS_HIGH_PERFORMANCE_MODE, UINT32_MAX, 50000U },
+};
+
+#define LEVEL_COUNT ((uint8_t)(sizeof(levels) / sizeof(levels[0])))
+
+static uint8_t odr_xl(LSM6DSO16IS_Simulator *sim)
+{
+    return (uint8_t)(sim->Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_CTRL1_XL) >> 4);
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static void start(LSM6DSO16IS *imu)
+{
+    TEST_CHECK(imu->begin() == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(imu->Enable_X() == LSM6DSO16IS_STATUS_OK);
+}
+
+static void test_hysteresis(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    LSM6DSO16IS_ODR_Governor governor(&imu, levels, LEVEL_COUNT, 0, 1);
+    LSM6DSO16IS_Governor_Stats_t stats;
+
+    start(&imu);
+    TEST_CHECK(governor.Start(0) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_12Hz5);
+    TEST_CHECK((sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_CTRL6_C) & CTRL6_C_XL_HM) != 0U);
+
+    /* Sotto la soglia di salita del livello 0 */
+    TEST_CHECK(governor.Update_Activity(999U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+
+    TEST_CHECK(governor.Update_Activity(2000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 1U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_104Hz);
+    TEST_CHECK((sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_CTRL6_C) & CTRL6_C_XL_HM) == 0U);
+
+    /* Dentro la banda di isteresi del livello 1: nessun passo */
+    TEST_CHECK(governor.Update_Activity(800U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Update_Activity(100000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 1U);
+
+    TEST_CHECK(governor.Update_Activity(200000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 2U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_833Hz);
+
+    /* Livello massimo */
+    TEST_CHECK(governor.Update_Activity(UINT32_MAX) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 2U);
+
+    TEST_CHECK(governor.Update_Activity(60000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 2U);
+    TEST_CHECK(governor.Update_Activity(10000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 1U);
+    TEST_CHECK(governor.Update_Activity(400U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_12Hz5);
+
+    TEST_CHECK(governor.Get_Stats(&stats) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(stats.level == 0U);
+    TEST_CHECK(stats.transitions == 4U);
+}
+
+static void test_min_dwell(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    LSM6DSO16IS_ODR_Governor governor(&imu, levels, LEVEL_COUNT, 50U, 1);
+
+    start(&imu);
+    TEST_CHECK(governor.Start(0) == LSM6DSO16IS_STATUS_OK);
+
+    TEST_CHECK(governor.Update_Activity(2000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_12Hz5);
+
+    sleep_ms(60);
+    TEST_CHECK(governor.Update_Activity(2000U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 1U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_104Hz);
+
+    /* La permanenza riparte a ogni passo */
+    TEST_CHECK(governor.Update_Activity(0U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 1U);
+    sleep_ms(60);
+    TEST_CHECK(governor.Update_Activity(0U) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+}
+
+static void test_long_dwell(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    /* Oltre UINT32_MAX microsecondi: non deve accorciarsi */
+    LSM6DSO16IS_ODR_Governor governor(&imu, levels, LEVEL_COUNT, 4294968U, 1);
+
+    start(&imu);
+    TEST_CHECK(governor.Start(0) == LSM6DSO16IS_STATUS_OK);
+    sleep_ms(5);
+    TEST_CHECK(governor.Update_Activity(UINT32_MAX) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+}
+
+static void test_samples(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    LSM6DSO16IS_ODR_Governor governor(&imu, levels, LEVEL_COUNT, 0, 16);
+    int32_t still[3] = { 10, -20, 1000 };
+    int32_t moving[3];
+
+    start(&imu);
+    TEST_CHECK(governor.Start(1) == LSM6DSO16IS_STATUS_OK);
+
+    /* Varianza nulla: scende sotto la soglia del livello 1 a fine finestra */
+    for (uint8_t i = 0; i < 15U; i++) {
+        TEST_CHECK(governor.Update_Sample(still) == LSM6DSO16IS_STATUS_OK);
+    }
+    TEST_CHECK(governor.Get_Level() == 1U);
+    TEST_CHECK(governor.Update_Sample(still) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Level() == 0U);
+
+    /* +-100 LSB su ogni asse: varianza 3 * 10000 */
+    for (uint8_t i = 0; i < 16U; i++) {
+        int32_t d = ((i & 1U) != 0U) ? 100 : -100;
+
+        moving[0] = still[0] + d;
+        moving[1] = still[1] - d;
+        moving[2] = still[2] + d;
+        TEST_CHECK(governor.Update_Sample(moving) == LSM6DSO16IS_STATUS_OK);
+    }
+    TEST_CHECK(governor.Get_Level() == 1U);
+    TEST_CHECK(odr_xl(&sim) == ODR_XL_104Hz);
+}
+
+static void test_no_levels(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    LSM6DSO16IS_ODR_Governor governor(&imu, levels, 0, 0, 1);
+    LSM6DSO16IS_Governor_Stats_t stats;
+    int32_t raw[3] = { 0, 0, 0 };
+
+    TEST_CHECK(governor.Start(0) != LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Update_Activity(0U) != LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Update_ISPU_Flag(1) != LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Update_Sample(raw) != LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(governor.Get_Stats(&stats) != LSM6DSO16IS_STATUS_OK);
+}
+
+int main(void)
+{
+    test_hysteresis();
+    test_min_dwell();
+    test_long_dwell();
+    test_samples();
+    test_no_levels();
+
+    return test_failures();
+}
@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * Bus cost of the unmodified driver, run on the device simulator.
+ *
+ *   simulator_benchmark [calls]
+ *
+ * Each API is called [calls] times in its steady state (sensors enabled, the
+ * configuration already applied); the table reports, per call, the
+ * transactions, bytes and bank switches seen by the simulator and the bus
+ * time at 400 kHz I2C, then the host throughput of Get_X_Axes with a zero-cost
+ * bus. The test fails if a call fails or if the raw axis reads are not
+ * single burst transactions.
+ */
+
+#include "LSM6DSO16IS_Simulator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef LSM6DSO16ISStatusTypeDef (*Bench_Call_t)(LSM6DSO16IS &imu);
+
+typedef struct {
+    const char *name;
+    Bench_Call_t call;
+    uint8_t burst = 0;    /* Deve costare una sola transazione */
+} Bench_Api_t;
+
+static LSM6DSO16IS_Config_t config;
+
+static const Bench_Api_t apis[] = {
+    { "ReadID", [](LSM6DSO16IS &imu) {
+        uint8_t id;
+        /* ReadID riporta errore anche quando la lettura riesce */
+        (void)imu.ReadID(&id);
+        return LSM6DSO16IS_STATUS_OK;
+    } },
+    { "Apply_Config", [](LSM6DSO16IS &imu) { return imu.Apply_Config(&config); } },
+    { "Set_X_ODR", [](LSM6DSO16IS &imu) { return imu.Set_X_ODR(104.0f); } },
+    { "Set_X_FS", [](LSM6DSO16IS &imu) { return imu.Set_X_FS(4); } },
+    { "Get_X_Axes", [](LSM6DSO16IS &imu) { float v[3]; return imu.Get_X_Axes(v); } },
+    { "Get_X_AxesRaw", [](LSM6DSO16IS &imu) { int32_t v[3]; return imu.Get_X_AxesRaw(v); }, 1 },
+    { "Set_G_ODR", [](LSM6DSO16IS &imu) { return imu.Set_G_ODR(104.0f); } },
+    { "Set_G_FS", [](LSM6DSO16IS &imu) { return imu.Set_G_FS(500); } },
+    { "Get_G_Axes", [](LSM6DSO16IS &imu) { float v[3]; return imu.Get_G_Axes(v); } },
+    { "Get_G_AxesRaw", [](LSM6DSO16IS &imu) { int32_t v[3]; return imu.Get_G_AxesRaw(v); }, 1 },
+    { "Get_X_DRDY_Status", [](LSM6DSO16IS &imu) { uint8_t s; return imu.Get_X_DRDY_Status(&s); } },
+    { "Get_Timestamp", [](LSM6DSO16IS &imu) { uint32_t t; return imu.Get_Timestamp(&t); } },
+    { "Read_Reg", [](LSM6DSO16IS &imu) { uint8_t d; return imu.Read_Reg(LSM6DSO16IS_STATUS_REG, &d); } },
+    { "Read_Reg x12", [](LSM6DSO16IS &imu) {
+        uint8_t d[12];
+        return imu.Read_Reg(LSM6DSO16IS_OUTX_L_G, d, sizeof(d));
+    } },
+    { "Read_Reg_Groups", [](LSM6DSO16IS &imu) {
+        uint8_t status;
+        uint8_t out[12];
+        LSM6DSO16IS_Read_Group_t groups[2] = {
+            { LSM6DSO16IS_STATUS_REG, &status, 1 },
+            { LSM6DSO16IS_OUTX_L_G, out, sizeof(out) },
+        };
+        return imu.Read_Reg_Groups(groups, 2);
+    } },
+    { "Write_Reg", [](LSM6DSO16IS &imu) { return imu.Write_Reg(LSM6DSO16IS_INT1_CTRL, 0x00); } },
+    { "Get_ISPU_Status", [](LSM6DSO16IS &imu) { LSM6DSO16IS_ISPU_Status_t s; return imu.Get_ISPU_Status(&s); } },
+    { "Read_ISPU_Output", [](LSM6DSO16IS &imu) {
+        uint8_t d[8];
+        return imu.Read_ISPU_Output(LSM6DSO16IS_ISPU_DOUT_00_L, d, sizeof(d));
+    } },
+    { "Write_ISPU_Mailbox", [](LSM6DSO16IS &imu) {
+        uint16_t w[2] = { 0x1234, 0x5678 };
+        return imu.Write_ISPU_Mailbox(w, 2, 0x0001);
+    } },
+};
+
+#define BENCH_API_COUNT (sizeof(apis) / sizeof(apis[0]))
+
+int main(int argc, char **argv)
+{
+    uint32_t calls = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100U;
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS imu(&sim);
+    LSM6DSO16IS_Sim_Stats_t before;
+    LSM6DSO16IS_Sim_Stats_t after;
+    uint32_t errors = 0;
+    int ret = 0;
+
+    if (calls == 0U) {
+        fprintf(stderr, "usage: %s [calls]\n", argv[0]);
+        return 2;
+    }
+
+    LSM6DSO16IS::Get_Default_Config(&config);
+    if ((imu.begin() != LSM6DSO16IS_STATUS_OK) || (imu.Enable_X() != LSM6DSO16IS_STATUS_OK) ||
+        (imu.Enable_G() != LSM6DSO16IS_STATUS_OK) || (imu.Set_Timestamp(1) != LSM6DSO16IS_STATUS_OK) ||
+        (imu.Apply_Config(&config) != LSM6DSO16IS_STATUS_OK)) {
+        fprintf(stderr, "driver setup failed\n");
+        return 1;
+    }
+
+    printf("%-20s %8s %8s %8s %8s %10s\n", "api", "calls", "trans", "bytes", "banks", "bus us");
+    for (uint32_t i = 0; i < BENCH_API_COUNT; i++) {
+        uint64_t start_us;
+        uint32_t transactions;
+
+        /* La prima chiamata porta il driver a regime, non viene contata */
+        if (apis[i].call(imu) != LSM6DSO16IS_STATUS_OK) {
+            errors++;
+        }
+        sim.Get_Stats(&before);
+        start_us = sim.Get_Time_us();
+        for (uint32_t n = 0; n < calls; n++) {
+            if (apis[i].call(imu) != LSM6DSO16IS_STATUS_OK) {
+                errors++;
+            }
+        }
+        sim.Get_Stats(&after);
+        transactions = after.transactions - before.transactions;
+
+        printf("%-20s %8u %8.2f %8.2f %8.2f %10.1f\n", apis[i].name, calls, (double)transactions / calls,
+               (double)(after.bytes - before.bytes) / calls,
+               (double)(after.bank_switches - before.bank_switches) / calls,
+               (double)(sim.Get_Time_us() - start_us) / calls);
+
+        /* Le letture grezze degli assi sono un solo burst */
+        if (apis[i].burst && (transactions != calls)) {
+            fprintf(stderr, "%s: %u transactions for %u calls\n", apis[i].name, transactions, calls);
+            ret = 1;
+        }
+    }
+
+    /* Throughput dell'host, senza il costo del bus */
+    {
+        const uint32_t samples = calls * 1000U;
+        float v[3];
+
+        sim.Set_Bus_Timing(0, 0);
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < samples; n++) {
+            if (imu.Get_X_Axes(v) != LSM6DSO16IS_STATUS_OK) {
+                errors++;
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+        printf("Get_X_Axes host      %8.1f ns/call  %10.0f calls/s\n", ns / samples, samples * 1e9 / ns);
+    }
+
+    if (errors != 0U) {
+        fprintf(stderr, "%u call(s) failed\n", errors);
+        ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) [2024] 
+Organization: Perlatecnica APS ETS
+Author: Mauro D'Angelo
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * begin() and Begin_Warm() after an MCU reset that left the sensor with the
+ * ISPU bank selected, as a reset in the middle of Read_ISPU_Output() does.
+ */
+
+#include "LSM6DSO16IS_Simulator.h"
+#include "LSM6DSO16IS_Test.h"
+
+#define FUNC_CFG_ISPU    0x80U
+
+/* A first driver instance configures the sensor, then the MCU resets with the ISPU bank selected */
+static void run_then_reset(LSM6DSO16IS_Simulator *sim, const LSM6DSO16IS_Config_t *config)
+{
+    LSM6DSO16IS imu(sim);
+    uint8_t ispu = FUNC_CFG_ISPU;
+
+    TEST_CHECK(imu.Apply_Config(config) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(sim->write(LSM6DSO16IS_FUNC_CFG_ACCESS, &ispu, 1) == 0);
+}
+
+static void test_warm_adopt(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS_Config_t config;
+    LSM6DSO16IS_Sim_Stats_t stats;
+    uint8_t adopted = 0;
+
+    LSM6DSO16IS::Get_Default_Config(&config);
+    config.xl_odr = 104.0f;
+    config.g_odr = 104.0f;
+    run_then_reset(&sim, &config);
+
+    LSM6DSO16IS imu(&sim);
+    sim.Reset_Stats();
+    TEST_CHECK(imu.Begin_Warm(&config, &adopted) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(adopted == 1U);
+    TEST_CHECK(sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_FUNC_CFG_ACCESS) == 0x00U);
+
+    /* Only the bank switch is written */
+    sim.Get_Stats(&stats);
+    TEST_CHECK(stats.writes == 1U);
+    TEST_CHECK(stats.bank_switches == 1U);
+}
+
+static void test_warm_main_bank(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS_Config_t config;
+    LSM6DSO16IS_Sim_Stats_t stats;
+    uint8_t adopted = 0;
+
+    LSM6DSO16IS::Get_Default_Config(&config);
+    config.xl_odr = 104.0f;
+    TEST_CHECK(LSM6DSO16IS(&sim).Apply_Config(&config) == LSM6DSO16IS_STATUS_OK);
+
+    /* Already in the main bank: no write at all */
+    LSM6DSO16IS imu(&sim);
+    sim.Reset_Stats();
+    TEST_CHECK(imu.Begin_Warm(&config, &adopted) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(adopted == 1U);
+    sim.Get_Stats(&stats);
+    TEST_CHECK(stats.writes == 0U);
+}
+
+static void test_warm_differs(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS_Config_t config;
+    uint8_t adopted = 1;
+
+    LSM6DSO16IS::Get_Default_Config(&config);
+    run_then_reset(&sim, &config);
+
+    /* The new configuration goes to the main bank, the ISPU bank is untouched */
+    config.xl_fs = 8;
+    LSM6DSO16IS imu(&sim);
+    TEST_CHECK(imu.Begin_Warm(&config, &adopted) == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(adopted == 0U);
+    TEST_CHECK(sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_FUNC_CFG_ACCESS) == 0x00U);
+    TEST_CHECK(((sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_CTRL1_XL) >> 2) & 0x3U) == 0x3U);
+    for (uint8_t reg = LSM6DSO16IS_CONFIG_FIRST_REG; reg <= LSM6DSO16IS_CONFIG_LAST_REG; reg++) {
+        TEST_CHECK(sim.Peek(LSM6DSO16IS_ISPU_MEM_BANK, reg) == 0x00U);
+    }
+}
+
+static void test_cold_begin(void)
+{
+    LSM6DSO16IS_Simulator sim;
+    LSM6DSO16IS_Config_t config;
+
+    LSM6DSO16IS::Get_Default_Config(&config);
+    run_then_reset(&sim, &config);
+
+    LSM6DSO16IS imu(&sim);
+    TEST_CHECK(imu.begin() == LSM6DSO16IS_STATUS_OK);
+    TEST_CHECK(sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_FUNC_CFG_ACCESS) == 0x00U);
+    /* BDU and IF_INC in the main bank CTRL3_C */
+    TEST_CHECK((sim.Peek(LSM6DSO16IS_MAIN_MEM_BANK, LSM6DSO16IS_CTRL3_C) & 0x44U) == 0x44U);
+    for (uint8_t reg = LSM6DSO16IS_CONFIG_FIRST_REG; reg <= LSM6DSO16IS_CONFIG_LAST_REG; reg++) {
+        TEST_CHECK(sim.Peek(LSM6DSO16IS_ISPU_MEM_BANK, reg) == 0x00U);
+    }
+}
+
+int main(void)
+{
+    test_warm_adopt();
+    test_warm_main_bank();
+    test_warm_differs();
+    test_cold_begin();
+
+    return test_failures();
+}